@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+#include "matrix.h"
+
+// Native kernels against the BLAS/LAPACK backend on the same inputs.
+// The second argument selects the backend: 0 = Native, 1 = Blas.
+
+static bool select_backend(benchmark::State& state) {
+  Backend backend = state.range(1) == 0 ? Backend::Native : Backend::Blas;
+  if (!backend_available(backend)) {
+    state.SkipWithError("backend not available in this build");
+    return false;
+  }
+  set_backend(backend);
+  state.SetLabel(backend == Backend::Native ? "native" : "blas");
+  return true;
+}
+
+// Benchmarking matrix-matrix multiplication per backend
+static void Multiplication_Backend(benchmark::State& state) {
+  int n = state.range(0);
+  Matrix A = Matrix::Random(n, n);
+  Matrix B = Matrix::Random(n, n);
+  Backend saved = get_backend();
+  if (!select_backend(state)) return;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(A * B);
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+  set_backend(saved);
+}
+
+// Benchmarking EigSym per backend
+static void EigSym_Backend(benchmark::State& state) {
+  int n = state.range(0);
+  Matrix B = Matrix::Random(n, n);
+  Matrix A = B + B.t();
+  Backend saved = get_backend();
+  if (!select_backend(state)) return;
+
+  for (auto _ : state) {
+    auto result = A.eigsym();
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+  set_backend(saved);
+}
+
+// Run benchmarking for different matrix sizes and both backends
+BENCHMARK(Multiplication_Backend)
+  ->ArgsProduct({{100, 200, 400}, {0, 1}});
+
+BENCHMARK(EigSym_Backend)
+  ->ArgsProduct({{100, 200, 400}, {0, 1}});
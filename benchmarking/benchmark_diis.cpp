@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+#include "matrix.h"
+#include "diis.hpp"
+#include "factorizations.hpp"
+#include <deque>
+
+// Cost of one DIIS step with a full subspace of 8 vectors: the incremental
+// update (one new row of B, Fock matrix written in place) against
+// rebuilding B from all stored errors and forming a new matrix each step
+
+static constexpr index_t num_vectors = 8;
+
+static void DIIS_Incremental(benchmark::State& state) {
+  index_t n = state.range(0);
+  std::vector<Matrix> Fs, Es;
+  for (index_t k = 0; k < num_vectors + 1; k++) {
+    Fs.push_back(Matrix::Random(n, n));
+    Es.push_back(Matrix::Random(n, n));
+  }
+  DIIS diis(num_vectors);
+  Matrix F(n, n);
+  std::size_t k = 0;
+
+  for (auto _ : state) {
+    F = Fs[k % Fs.size()];
+    diis.extrapolate(F, Es[k % Es.size()]);
+    benchmark::DoNotOptimize(F.memptr());
+    k++;
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+static void DIIS_Rebuild(benchmark::State& state) {
+  index_t n = state.range(0);
+  std::vector<Matrix> Fs, Es;
+  for (index_t k = 0; k < num_vectors + 1; k++) {
+    Fs.push_back(Matrix::Random(n, n));
+    Es.push_back(Matrix::Random(n, n));
+  }
+  std::deque<Matrix> focks, errors;
+  std::size_t k = 0;
+
+  for (auto _ : state) {
+    focks.push_back(Fs[k % Fs.size()]);
+    errors.push_back(Es[k % Es.size()]);
+    if (static_cast<index_t>(focks.size()) > num_vectors) {
+      focks.pop_front();
+      errors.pop_front();
+    }
+    index_t m = focks.size();
+    Matrix A(m + 1, m + 1, Matrix::zeroed);
+    vec rhs(m + 1, 0.0);
+    rhs[m] = -1.0;
+    for (index_t i = 0; i < m; i++) {
+      for (index_t j = 0; j < m; j++) {
+        A(i, j) = dot(errors[i], errors[j]);
+      }
+      A(i, m) = A(m, i) = -1.0;
+    }
+    vec c = LUFactor(A).solve(rhs);
+    Matrix F = focks[0] * c[0];
+    for (index_t i = 1; i < m; i++) {
+      F = F + focks[i] * c[i];
+    }
+    benchmark::DoNotOptimize(F.memptr());
+    k++;
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+BENCHMARK(DIIS_Incremental)->Arg(200)->Arg(500)->Arg(1000);
+BENCHMARK(DIIS_Rebuild)->Arg(200)->Arg(500)->Arg(1000);
@@ -1,12 +1,14 @@
 #include <benchmark/benchmark.h>
 #include "matrix.h"
+#include "davidson.hpp"
 #include <armadillo>
+#include <string>
 
 // Benchmarking EigSym in Matrix Class
 static void EigSym_MatrixClass(benchmark::State& state) {
   int n = state.range(0);
   Matrix B = Matrix::Random(n, n);
-  Matrix A = B + B.transpose(); // create symmetric matrix A
+  Matrix A = B + B.t(); // create symmetric matrix A
 
   for (auto _ : state) {
     auto result = A.eigsym();
@@ -31,6 +33,109 @@ static void EigSym_Armadillo(benchmark::State& state) {
   state.SetItemsProcessed(state.iterations() * n * n);
 }
 
+// Native eigensolvers on the same input. The second argument selects the
+// method: 0 = HouseholderQL, 1 = Jacobi.
+static void EigSym_Method(benchmark::State& state) {
+  int n = state.range(0);
+  EigsymMethod method = state.range(1) == 0 ? EigsymMethod::HouseholderQL : EigsymMethod::Jacobi;
+  Matrix B = Matrix::Random(n, n);
+  Matrix A = B + B.t();
+
+  for (auto _ : state) {
+    auto result = A.eigsym(method);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+  state.SetLabel(method == EigsymMethod::Jacobi ? "jacobi" : "householder-ql");
+}
+
+// Late-SCF style update: the matrix moves by 1e-5 and the lowest k
+// eigenpairs are refined from the previous decomposition. The second
+// argument is k; compare with EigSym_MatrixClass at the same size.
+static void EigSym_WarmStart(benchmark::State& state) {
+  int n = state.range(0);
+  int k = state.range(1);
+  Matrix B = Matrix::Random(n, n, 1);
+  Matrix A = B + B.t();
+  Matrix P = Matrix::Random(n, n, 2);
+  EigsymResult previous = A.eigsym();
+  Matrix A2 = A + (P + P.t()) * 1e-5;
+
+  for (auto _ : state) {
+    auto result = A2.eigsym_warm(previous, k);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Lowest 8 eigenpairs of a diagonally dominant matrix with block Davidson;
+// compare with EigSym_MatrixClass, which computes all of them
+static void Davidson_Lowest8(benchmark::State& state) {
+  int n = state.range(0);
+  Matrix B = Matrix::Random(n, n, 3);
+  Matrix A = (B + B.t()) * 0.01;
+  for (int i = 0; i < n; i++) {
+    A(i, i) += i + 1.0;
+  }
+
+  for (auto _ : state) {
+    auto result = davidson(A, 8);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Thread scaling of the native Householder tridiagonalization, the O(n^3)
+// part of the native eigsym. The second argument is the thread count.
+static void Tridiagonalize_Threads(benchmark::State& state) {
+  int n = state.range(0);
+  int threads = state.range(1);
+  Matrix B = Matrix::Random(n, n);
+  Matrix A = B + B.t();
+  int saved = get_num_threads();
+  set_num_threads(threads);
+
+  for (auto _ : state) {
+    auto result = A.householder_tridiagonalize(true);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+  state.SetLabel(std::to_string(threads) + " threads");
+  set_num_threads(saved);
+}
+
+// S^-1/2 of an overlap-like matrix with funm_sym: one eigendecomposition
+// and one symmetric rank-n update
+static void InvSqrt_FunmSym(benchmark::State& state) {
+  int n = state.range(0);
+  Matrix B = Matrix::Random(n, n);
+  Matrix S = B * B.t() * (1.0 / n) + Matrix::Identity(n);
+
+  for (auto _ : state) {
+    Matrix X = S.invsqrtm_sym();
+    benchmark::DoNotOptimize(X.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// The same by hand: eigsym, diagmat and two general products
+static void InvSqrt_TwoProducts(benchmark::State& state) {
+  int n = state.range(0);
+  Matrix B = Matrix::Random(n, n);
+  Matrix S = B * B.t() * (1.0 / n) + Matrix::Identity(n);
+
+  for (auto _ : state) {
+    EigsymResult eig = S.eigsym();
+    vec d(n);
+    for (int i = 0; i < n; i++) {
+      d[i] = 1.0 / std::sqrt(eig.eigenvalues[i]);
+    }
+    Matrix X = eig.eigenvectors * Matrix::diagmat(d).to_dense() * eig.eigenvectors.t();
+    benchmark::DoNotOptimize(X.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
 // Run benchmarking for different matrix sizes
 BENCHMARK(EigSym_MatrixClass)
   ->Arg(10)
@@ -43,3 +148,27 @@ BENCHMARK(EigSym_Armadillo)
   ->Arg(100)
   ->Arg(200)
   ->Arg(400);
+
+BENCHMARK(EigSym_Method)
+  ->ArgsProduct({{10, 100, 200, 400}, {0, 1}});
+
+BENCHMARK(EigSym_WarmStart)
+  ->Args({100, 10})
+  ->Args({400, 20})
+  ->Args({400, 40});
+
+BENCHMARK(Davidson_Lowest8)
+  ->Arg(400)
+  ->Arg(2000);
+
+BENCHMARK(Tridiagonalize_Threads)
+  ->ArgsProduct({{400, 1000}, {1, 2, 4, 8}})
+  ->UseRealTime();
+
+BENCHMARK(InvSqrt_FunmSym)
+  ->Arg(400)
+  ->Arg(1000);
+
+BENCHMARK(InvSqrt_TwoProducts)
+  ->Arg(400)
+  ->Arg(1000);
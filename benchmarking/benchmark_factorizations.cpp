@@ -0,0 +1,151 @@
+#include <benchmark/benchmark.h>
+#include "matrix.h"
+#include "factorizations.hpp"
+#include "arma_interop.hpp"
+#include <armadillo>
+
+// Solving S X = B for a symmetric positive definite S and 16 right-hand
+// sides: factor-and-solve against Armadillo and against going through the
+// eigendecomposition, as the library had to before
+
+static constexpr index_t num_rhs = 16;
+
+// B B^T + n I, positive definite and well conditioned
+static Matrix spd_matrix(index_t n) {
+  Matrix B = Matrix::Random(n, n);
+  Matrix S = B * B.t();
+  for (index_t i = 0; i < n; i++) {
+    S(i, i) += n;
+  }
+  return S;
+}
+
+static void Cholesky_Factor(benchmark::State& state) {
+  index_t n = state.range(0);
+  Matrix S = spd_matrix(n);
+
+  for (auto _ : state) {
+    CholeskyFactor chol(S);
+    benchmark::DoNotOptimize(chol.upper().memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+static void Cholesky_Armadillo(benchmark::State& state) {
+  index_t n = state.range(0);
+  arma::mat S = to_arma(spd_matrix(n));
+
+  for (auto _ : state) {
+    arma::mat U = arma::chol(S);
+    benchmark::DoNotOptimize(U.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+static void Solve_Cholesky(benchmark::State& state) {
+  index_t n = state.range(0);
+  Matrix S = spd_matrix(n);
+  Matrix B = Matrix::Random(n, num_rhs);
+
+  for (auto _ : state) {
+    Matrix X = CholeskyFactor(S).solve(B);
+    benchmark::DoNotOptimize(X.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+static void Solve_LDLT(benchmark::State& state) {
+  index_t n = state.range(0);
+  Matrix S = spd_matrix(n);
+  Matrix B = Matrix::Random(n, num_rhs);
+
+  for (auto _ : state) {
+    Matrix X = LDLTFactor(S).solve(B);
+    benchmark::DoNotOptimize(X.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// X = V diag(1/w) V^T B
+static void Solve_Eigsym(benchmark::State& state) {
+  index_t n = state.range(0);
+  Matrix S = spd_matrix(n);
+  Matrix B = Matrix::Random(n, num_rhs);
+
+  for (auto _ : state) {
+    Matrix X = S.funm_sym([](double w) { return 1.0 / w; }) * B;
+    benchmark::DoNotOptimize(X.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+static void Solve_Armadillo(benchmark::State& state) {
+  index_t n = state.range(0);
+  arma::mat S = to_arma(spd_matrix(n));
+  arma::mat B = arma::randu<arma::mat>(n, num_rhs);
+
+  for (auto _ : state) {
+    arma::mat X = arma::solve(S, B);
+    benchmark::DoNotOptimize(X.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// General (nonsymmetric) A X = B by LU with partial pivoting against
+// Armadillo, which also goes through an LU for a general matrix
+static void Solve_LU(benchmark::State& state) {
+  index_t n = state.range(0);
+  Matrix A = Matrix::Random(n, n);
+  Matrix B = Matrix::Random(n, num_rhs);
+
+  for (auto _ : state) {
+    Matrix X = LUFactor(A).solve(B);
+    benchmark::DoNotOptimize(X.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+static void Solve_ArmadilloGeneral(benchmark::State& state) {
+  index_t n = state.range(0);
+  arma::mat A = arma::randu<arma::mat>(n, n);
+  arma::mat B = arma::randu<arma::mat>(n, num_rhs);
+
+  for (auto _ : state) {
+    arma::mat X = arma::solve(A, B);
+    benchmark::DoNotOptimize(X.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+static void Inverse_LU(benchmark::State& state) {
+  index_t n = state.range(0);
+  Matrix A = Matrix::Random(n, n);
+
+  for (auto _ : state) {
+    Matrix A_inv = LUFactor(A).inverse();
+    benchmark::DoNotOptimize(A_inv.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+static void Inverse_Armadillo(benchmark::State& state) {
+  index_t n = state.range(0);
+  arma::mat A = arma::randu<arma::mat>(n, n);
+
+  for (auto _ : state) {
+    arma::mat A_inv = arma::inv(A);
+    benchmark::DoNotOptimize(A_inv.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+BENCHMARK(Cholesky_Factor)->Arg(250)->Arg(500)->Arg(1000);
+BENCHMARK(Cholesky_Armadillo)->Arg(250)->Arg(500)->Arg(1000);
+BENCHMARK(Solve_Cholesky)->Arg(250)->Arg(500)->Arg(1000);
+BENCHMARK(Solve_LDLT)->Arg(250)->Arg(500)->Arg(1000);
+BENCHMARK(Solve_Eigsym)->Arg(250)->Arg(500);
+BENCHMARK(Solve_Armadillo)->Arg(250)->Arg(500)->Arg(1000);
+BENCHMARK(Solve_LU)->Arg(250)->Arg(500)->Arg(1000);
+BENCHMARK(Solve_ArmadilloGeneral)->Arg(250)->Arg(500)->Arg(1000);
+BENCHMARK(Inverse_LU)->Arg(250)->Arg(500);
+BENCHMARK(Inverse_Armadillo)->Arg(250)->Arg(500);
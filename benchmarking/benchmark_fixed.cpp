@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+#include "matrix.h"
+#include "fixed_matrix.hpp"
+#include <armadillo>
+
+// Small-matrix workloads: a 3x3 product and a 3x3 symmetric eigensolve,
+// per call, for the stack-allocated FixedMatrix against the heap-backed types
+
+// Benchmarking a 3x3 product with FixedMatrix
+static void Multiplication3_FixedMatrix(benchmark::State& state) {
+    Matrix3 A(Matrix::Random(3, 3));
+    Matrix3 B(Matrix::Random(3, 3));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(A);
+        Matrix3 C = A * B;
+        benchmark::DoNotOptimize(C);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Benchmarking a 3x3 product in Matrix Class
+static void Multiplication3_MatrixClass(benchmark::State& state) {
+    Matrix A = Matrix::Random(3, 3);
+    Matrix B = Matrix::Random(3, 3);
+
+    for (auto _ : state) {
+        Matrix C = A * B;
+        benchmark::DoNotOptimize(C.memptr());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Benchmarking a 3x3 product in Armadillo (dynamic size)
+static void Multiplication3_Armadillo(benchmark::State& state) {
+    arma::mat A = arma::randu<arma::mat>(3, 3);
+    arma::mat B = arma::randu<arma::mat>(3, 3);
+
+    for (auto _ : state) {
+        arma::mat C = A * B;
+        benchmark::DoNotOptimize(C.memptr());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Benchmarking a 3x3 symmetric eigensolve with FixedMatrix (Jacobi)
+static void Eigsym3_FixedMatrix(benchmark::State& state) {
+    Matrix3 A(Matrix::Random(3, 3));
+    Matrix3 S = A + A.transpose();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(S);
+        FixedEigsymResult<3> res = eigsym(S);
+        benchmark::DoNotOptimize(res);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Benchmarking a 3x3 symmetric eigensolve in Matrix Class
+static void Eigsym3_MatrixClass(benchmark::State& state) {
+    Matrix A = Matrix::Random(3, 3);
+    Matrix S = A + A.t();
+
+    for (auto _ : state) {
+        EigsymResult res = S.eigsym();
+        benchmark::DoNotOptimize(res.eigenvectors.memptr());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(Multiplication3_FixedMatrix);
+BENCHMARK(Multiplication3_MatrixClass);
+BENCHMARK(Multiplication3_Armadillo);
+BENCHMARK(Eigsym3_FixedMatrix);
+BENCHMARK(Eigsym3_MatrixClass);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include "matrix.h"
+#include <armadillo>
+
+// Benchmarking the matrix-vector product in Matrix Class
+static void Gemv_MatrixClass(benchmark::State& state) {
+  int n = state.range(0);
+  Matrix A = Matrix::Random(n, n);
+  vec x = Matrix::Random(n, 1).copy_data();
+
+  for (auto _ : state) {
+    vec y = A * x;
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Benchmarking the symmetric (upper triangle) matrix-vector product in Matrix Class
+static void Symv_MatrixClass(benchmark::State& state) {
+  int n = state.range(0);
+  Matrix B = Matrix::Random(n, n);
+  Matrix A = B + B.t();
+  vec x = Matrix::Random(n, 1).copy_data();
+
+  for (auto _ : state) {
+    vec y = A.symv(x);
+    benchmark::DoNotOptimize(y.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Benchmarking the matrix-vector product in Armadillo
+static void Gemv_Armadillo(benchmark::State& state) {
+  int n = state.range(0);
+  arma::mat A = arma::randu<arma::mat>(n, n);
+  arma::vec x = arma::randu<arma::mat>(n, 1).col(0);
+
+  for (auto _ : state) {
+    arma::vec y = A * x;
+    benchmark::DoNotOptimize(y.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Run benchmarking for different matrix sizes
+BENCHMARK(Gemv_MatrixClass)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(400)
+  ->Arg(2000);
+
+BENCHMARK(Symv_MatrixClass)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(400)
+  ->Arg(2000);
+
+BENCHMARK(Gemv_Armadillo)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(400)
+  ->Arg(2000);
@@ -42,6 +42,29 @@ static void InitializationRandom_Armadillo(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations() * n * n);
 }
 
+// Benchmarking a deep copy of a Matrix
+static void Copy_MatrixClass(benchmark::State& state) {
+    int n = state.range(0);
+    Matrix A = Matrix::Random(n, n);
+    for (auto _ : state) {
+        Matrix B = A;
+        benchmark::DoNotOptimize(B);
+    }
+    state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Benchmarking a copy of a copy-on-write Matrix (shares the buffer)
+static void CopyOnWrite_MatrixClass(benchmark::State& state) {
+    int n = state.range(0);
+    Matrix A = Matrix::Random(n, n);
+    A.set_copy_on_write();
+    for (auto _ : state) {
+        Matrix B = A;
+        benchmark::DoNotOptimize(B);
+    }
+    state.SetItemsProcessed(state.iterations() * n * n);
+}
+
 // Run benchmarking for different matrix sizes
 BENCHMARK(InitializationZeros_MatrixClass)
   ->Arg(10)
@@ -66,3 +89,15 @@ BENCHMARK(InitializationRandom_Armadillo)
   ->Arg(100)
   ->Arg(200)
   ->Arg(400);
+
+BENCHMARK(Copy_MatrixClass)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(200)
+  ->Arg(400);
+
+BENCHMARK(CopyOnWrite_MatrixClass)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(200)
+  ->Arg(400);
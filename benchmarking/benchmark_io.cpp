@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include "matrix.h"
+#include <armadillo>
+#include <sstream>
+
+// Benchmarking writing a matrix as CSV text in Matrix Class
+static void TextWrite_MatrixClass(benchmark::State& state) {
+  int n = state.range(0);
+  Matrix A = Matrix::Random(n, n);
+
+  for (auto _ : state) {
+    std::ostringstream out;
+    Matrix::write_text(out, A, TextFormat::CSV);
+    benchmark::DoNotOptimize(out.str().data());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Benchmarking writing a matrix as CSV text in Armadillo
+static void TextWrite_Armadillo(benchmark::State& state) {
+  int n = state.range(0);
+  arma::mat A = arma::randu<arma::mat>(n, n);
+
+  for (auto _ : state) {
+    std::ostringstream out;
+    A.save(out, arma::csv_ascii);
+    benchmark::DoNotOptimize(out.str().data());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Benchmarking parsing CSV text into a matrix in Matrix Class
+static void TextRead_MatrixClass(benchmark::State& state) {
+  int n = state.range(0);
+  std::ostringstream out;
+  Matrix::write_text(out, Matrix::Random(n, n), TextFormat::CSV);
+  const std::string text = out.str();
+
+  for (auto _ : state) {
+    std::istringstream in(text);
+    Matrix A = Matrix::read_text(in, TextFormat::CSV);
+    benchmark::DoNotOptimize(A);
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Benchmarking parsing CSV text into a matrix in Armadillo
+static void TextRead_Armadillo(benchmark::State& state) {
+  int n = state.range(0);
+  std::ostringstream out;
+  arma::mat(arma::randu<arma::mat>(n, n)).save(out, arma::csv_ascii);
+  const std::string text = out.str();
+
+  for (auto _ : state) {
+    std::istringstream in(text);
+    arma::mat A;
+    A.load(in, arma::csv_ascii);
+    benchmark::DoNotOptimize(A.memptr());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Run benchmarking for different matrix sizes
+BENCHMARK(TextWrite_MatrixClass)
+  ->Arg(100)
+  ->Arg(400)
+  ->Arg(1000);
+
+BENCHMARK(TextWrite_Armadillo)
+  ->Arg(100)
+  ->Arg(400)
+  ->Arg(1000);
+
+BENCHMARK(TextRead_MatrixClass)
+  ->Arg(100)
+  ->Arg(400)
+  ->Arg(1000);
+
+BENCHMARK(TextRead_Armadillo)
+  ->Arg(100)
+  ->Arg(400)
+  ->Arg(1000);
@@ -27,6 +27,31 @@ static void Multiplication_Armadillo(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations() * n * n);
 }
 
+// Benchmarking A^T * B through the lazy transpose (no transposed copy)
+static void TransposedMultiplication_MatrixClass(benchmark::State& state) {
+    int n = state.range(0);
+    Matrix A = Matrix::Random(n, n);
+    Matrix B = Matrix::Random(n, n);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(A.t() * B);
+    }
+    state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Benchmarking A^T * B in Armadillo
+static void TransposedMultiplication_Armadillo(benchmark::State& state) {
+    int n = state.range(0);
+    arma::mat A = arma::randu<arma::mat>(n, n);
+    arma::mat B = arma::randu<arma::mat>(n, n);
+
+    for (auto _ : state) {
+      arma::mat C = A.t() * B;
+      benchmark::DoNotOptimize(C.memptr());
+    }
+    state.SetItemsProcessed(state.iterations() * n * n);
+}
+
 // Run benchmarking for different matrix sizes
 BENCHMARK(Multiplication_MatrixClass)
   ->Arg(10)
@@ -39,3 +64,15 @@ BENCHMARK(Multiplication_Armadillo)
   ->Arg(100)
   ->Arg(200)
   ->Arg(400);
+
+BENCHMARK(TransposedMultiplication_MatrixClass)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(200)
+  ->Arg(400);
+
+BENCHMARK(TransposedMultiplication_Armadillo)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(200)
+  ->Arg(400);
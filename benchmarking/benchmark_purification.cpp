@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include "matrix.h"
+#include "purification.hpp"
+#include "sparse_matrix.hpp"
+
+// Density matrix at half filling of a dimerized chain (an insulator), by
+// TC2 purification against diagonalization followed by P = C_occ C_occ^T
+
+// chain with alternating on-site energies and nearest/next-nearest hopping
+static Matrix chain_fock(index_t n) {
+    Matrix F(n, n, Matrix::zeroed);
+    for (index_t i = 0; i < n; i++) {
+        F(i, i) = i % 2 == 0 ? -1.0 : 1.0;
+        if (i + 1 < n) F(i, i + 1) = F(i + 1, i) = -0.5;
+        if (i + 2 < n) F(i, i + 2) = F(i + 2, i) = 0.1;
+    }
+    return F;
+}
+
+static void Density_Eigsym(benchmark::State& state) {
+    index_t n = state.range(0);
+    Matrix F = chain_fock(n);
+
+    for (auto _ : state) {
+        EigsymResult eig = F.eigsym();
+        Matrix C = eig.eigenvectors.to_layout(Layout::ColMajor);
+        Matrix C_occ(vec(C.memptr(), C.memptr() + n * (n / 2)), n, n / 2, Layout::ColMajor);
+        Matrix P = C_occ * C_occ.t();
+        benchmark::DoNotOptimize(P.memptr());
+    }
+    state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+static void Density_PurifyDense(benchmark::State& state) {
+    index_t n = state.range(0);
+    Matrix F = chain_fock(n);
+
+    for (auto _ : state) {
+        auto result = purify_density(F, n / 2);
+        benchmark::DoNotOptimize(result.density.memptr());
+    }
+    state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+static void Density_PurifySparse(benchmark::State& state) {
+    index_t n = state.range(0);
+    SparseMatrix F = SparseMatrix::from_dense(chain_fock(n));
+    PurificationOptions options;
+    options.drop_tol = 1e-9;
+
+    for (auto _ : state) {
+        auto result = purify_density(F, n / 2, options);
+        benchmark::DoNotOptimize(result.density.get_values().data());
+    }
+    state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+BENCHMARK(Density_Eigsym)->Arg(400)->Arg(1000);
+BENCHMARK(Density_PurifyDense)->Arg(400)->Arg(1000);
+BENCHMARK(Density_PurifySparse)->Arg(400)->Arg(1000)->Arg(4000);
@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+#include "matrix.h"
+#include <armadillo>
+
+// Benchmarking trace(A*B) without forming the product in Matrix Class
+static void TraceProd_MatrixClass(benchmark::State& state) {
+  int n = state.range(0);
+  Matrix A = Matrix::Random(n, n);
+  Matrix B = Matrix::Random(n, n);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(trace_prod(A, B));
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Benchmarking trace(A*B) in Armadillo
+static void TraceProd_Armadillo(benchmark::State& state) {
+  int n = state.range(0);
+  arma::mat A = arma::randu<arma::mat>(n, n);
+  arma::mat B = arma::randu<arma::mat>(n, n);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(arma::trace(A * B));
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Benchmarking the Frobenius norm in Matrix Class
+static void NormFro_MatrixClass(benchmark::State& state) {
+  int n = state.range(0);
+  Matrix A = Matrix::Random(n, n);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(A.norm_fro());
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Benchmarking the Frobenius norm in Armadillo
+static void NormFro_Armadillo(benchmark::State& state) {
+  int n = state.range(0);
+  arma::mat A = arma::randu<arma::mat>(n, n);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(arma::norm(A, "fro"));
+  }
+  state.SetItemsProcessed(state.iterations() * n * n);
+}
+
+// Run benchmarking for different matrix sizes
+BENCHMARK(TraceProd_MatrixClass)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(200)
+  ->Arg(400);
+
+BENCHMARK(TraceProd_Armadillo)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(200)
+  ->Arg(400);
+
+BENCHMARK(NormFro_MatrixClass)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(200)
+  ->Arg(400);
+
+BENCHMARK(NormFro_Armadillo)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(200)
+  ->Arg(400);
@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+#include "matrix.h"
+#include "sparse_matrix.hpp"
+#include <cmath>
+
+// Products with a banded SparseMatrix, the shape of a density or Fock matrix
+// of a large gapped system with a local basis, against the dense products
+// on the same matrix. Cost should grow linearly in n for the sparse ones.
+
+// symmetric n x n band of half-width w with exponentially decaying entries
+static SparseMatrix banded_matrix(index_t n, index_t w) {
+    std::vector<index_t> row_ptr(n + 1, 0);
+    std::vector<index_t> col_idx;
+    vec values;
+    for (index_t i = 0; i < n; i++) {
+        for (index_t j = std::max<index_t>(0, i - w); j <= std::min(n - 1, i + w); j++) {
+            col_idx.push_back(j);
+            values.push_back(std::exp(-0.5 * std::abs(static_cast<double>(i - j))) / (1.0 + 0.01 * (i + j)));
+        }
+        row_ptr[i + 1] = static_cast<index_t>(col_idx.size());
+    }
+    return SparseMatrix(n, n, std::move(row_ptr), std::move(col_idx), std::move(values));
+}
+
+// Sparse times a block of 32 dense vectors
+static void SparseDense_Product(benchmark::State& state) {
+    index_t n = state.range(0);
+    SparseMatrix A = banded_matrix(n, 40);
+    Matrix X = Matrix::Random(n, 32);
+
+    for (auto _ : state) {
+        Matrix Y = A * X;
+        benchmark::DoNotOptimize(Y.memptr());
+    }
+    state.SetItemsProcessed(state.iterations() * A.nnz() * 32);
+}
+
+// The same product with the matrix stored densely
+static void SparseDense_DenseReference(benchmark::State& state) {
+    index_t n = state.range(0);
+    Matrix A = banded_matrix(n, 40).to_dense();
+    Matrix X = Matrix::Random(n, 32);
+
+    for (auto _ : state) {
+        Matrix Y = A * X;
+        benchmark::DoNotOptimize(Y.memptr());
+    }
+    state.SetItemsProcessed(state.iterations() * n * n * 32);
+}
+
+// Truncated sparse product, e.g. P * S * P in density matrix purification
+static void SparseSparse_Product(benchmark::State& state) {
+    index_t n = state.range(0);
+    SparseMatrix A = banded_matrix(n, 40);
+
+    for (auto _ : state) {
+        SparseMatrix C = A.multiply(A, 1e-10);
+        benchmark::DoNotOptimize(C.get_values().data());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// The same product with dense matrices
+static void SparseSparse_DenseReference(benchmark::State& state) {
+    index_t n = state.range(0);
+    Matrix A = banded_matrix(n, 40).to_dense();
+
+    for (auto _ : state) {
+        Matrix C = A * A;
+        benchmark::DoNotOptimize(C.memptr());
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+// Sum of two banded matrices
+static void Sparse_Addition(benchmark::State& state) {
+    index_t n = state.range(0);
+    SparseMatrix A = banded_matrix(n, 40);
+    SparseMatrix B = banded_matrix(n, 20);
+
+    for (auto _ : state) {
+        SparseMatrix C = A + B;
+        benchmark::DoNotOptimize(C.get_values().data());
+    }
+    state.SetItemsProcessed(state.iterations() * A.nnz());
+}
+
+BENCHMARK(SparseDense_Product)->Arg(2000)->Arg(8000)->Arg(32000);
+BENCHMARK(SparseDense_DenseReference)->Arg(2000);
+BENCHMARK(SparseSparse_Product)->Arg(2000)->Arg(8000)->Arg(32000);
+BENCHMARK(SparseSparse_DenseReference)->Arg(2000);
+BENCHMARK(Sparse_Addition)->Arg(8000)->Arg(32000);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <armadillo>
+#include <stdexcept>
+#include "matrix.h"
+
+// Armadillo stores matrices column-major. A column-major Matrix shares its
+// buffer with an Armadillo matrix of the same shape (arma_view, adopt_arma).
+// A row-major Matrix buffer read by Armadillo is the transpose, which the
+// *_transposed functions make explicit. to_arma and from_arma copy and keep
+// the orientation.
+
+/**
+ * @brief Armadillo matrix over a column-major M's buffer, same shape, no copy
+ *
+ * Uses Armadillo's auxiliary memory constructor in strict mode: writes go
+ * to M, and M must outlive the returned matrix.
+ *
+ * @throws std::runtime_error if M is row-major
+ */
+inline arma::mat arma_view(Matrix& M) {
+  if (M.get_layout() != Layout::ColMajor) {
+    throw std::runtime_error("arma_view requires a column-major Matrix");
+  }
+  return arma::mat(M.memptr(), M.get_num_rows(), M.get_num_cols(), false, true);
+}
+
+/**
+ * @brief Armadillo matrix over a row-major M's buffer holding M^T (cols x rows)
+ *
+ * @throws std::runtime_error if M is column-major
+ */
+inline arma::mat arma_view_transposed(Matrix& M) {
+  if (M.get_layout() != Layout::RowMajor) {
+    throw std::runtime_error("arma_view_transposed requires a row-major Matrix");
+  }
+  return arma::mat(M.memptr(), M.get_num_cols(), M.get_num_rows(), false, true);
+}
+
+/**
+ * @brief Non-owning column-major Matrix over A's buffer, same shape, no copy
+ *
+ * A must outlive the returned matrix and must not be resized meanwhile.
+ */
+inline Matrix adopt_arma(arma::mat& A) {
+  return Matrix::adopt(A.memptr(), static_cast<index_t>(A.n_rows), static_cast<index_t>(A.n_cols),
+                       Layout::ColMajor);
+}
+
+/**
+ * @brief Non-owning row-major Matrix over A's buffer holding A^T (n_cols x n_rows)
+ */
+inline Matrix adopt_transposed(arma::mat& A) {
+  return Matrix::adopt(A.memptr(), static_cast<index_t>(A.n_cols), static_cast<index_t>(A.n_rows));
+}
+
+/**
+ * @brief Copy of M as an Armadillo matrix of the same shape
+ *
+ * A straight copy for column-major M, one transposing pass otherwise; no
+ * per-element accessors.
+ */
+inline arma::mat to_arma(const Matrix& M) {
+  if (M.get_layout() == Layout::ColMajor) {
+    return arma::mat(M.memptr(), M.get_num_rows(), M.get_num_cols());
+  }
+  const arma::mat Mt(const_cast<double*>(M.memptr()), M.get_num_cols(), M.get_num_rows(), false, true);
+  return Mt.t();
+}
+
+/**
+ * @brief Copy of A as a row-major Matrix of the same shape
+ *
+ * Use adopt_arma(A) or adopt_arma(A).to_layout(...) to pick another layout.
+ */
+inline Matrix from_arma(const arma::mat& A) {
+  Matrix At = Matrix::adopt(const_cast<double*>(A.memptr()),
+                            static_cast<index_t>(A.n_cols), static_cast<index_t>(A.n_rows));
+  return At.t();
+}
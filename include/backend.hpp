@@ -0,0 +1,33 @@
+#pragma once
+
+/**
+ * @brief Implementation used for the dense kernels that have a vendor
+ *        counterpart (matrix-matrix products and eigsym)
+ *
+ * Native runs the library's own kernels. Blas routes products to dgemm and
+ * eigsym to LAPACK dsyevd; it is only available when the library was
+ * configured with MATRIXLIBRARY_USE_BLAS (the default).
+ */
+enum class Backend { Native, Blas };
+
+/**
+ * @brief Backend currently in use
+ *
+ * Defaults to Blas when it is available, or to the value of the
+ * MATRIXLIBRARY_BACKEND environment variable ("native" or "blas") when it
+ * is set. An unavailable backend requested through the environment falls
+ * back to Native.
+ */
+Backend get_backend();
+
+/**
+ * @brief Select the backend for subsequent calls
+ *
+ * @throws std::runtime_error if the backend was not compiled in
+ */
+void set_backend(Backend backend);
+
+/**
+ * @brief True if the backend was compiled in
+ */
+bool backend_available(Backend backend);
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <functional>
+#include "matrix.h"
+#include "sparse_matrix.hpp"
+
+// Block Davidson solver for the lowest eigenpairs of large symmetric
+// operators. The operator is only touched through block products A * X, so
+// it never has to be stored densely: a Matrix, a sparse matrix or a
+// matrix-free callback all work.
+
+/**
+ * @brief Block product A * X of a symmetric n x n operator
+ *
+ * X is n x b and column-major; the result must be n x b, in either layout.
+ */
+using BlockOperator = std::function<Matrix(const Matrix&)>;
+
+/**
+ * @brief Settings for davidson()
+ */
+struct DavidsonOptions {
+  double tol = 1e-8;          // converged once every ||A x - theta x||_2 <= tol
+  int max_iterations = 200;
+  index_t max_subspace = 0;   // basis size that triggers a restart, at least 2k;
+                              // 0 picks max(8k, 32), capped at n
+  Matrix guess;               // optional n x k starting vectors; when empty, unit
+                              // vectors at the k smallest diagonal entries
+};
+
+/**
+ * @brief Lowest eigenpairs found by davidson()
+ */
+struct DavidsonResult {
+  vec eigenvalues;      // ascending
+  Matrix eigenvectors;  // n x k, one eigenvector per column, column-major
+  vec residual_norms;   // ||A x - theta x||_2 per eigenpair
+  int iterations = 0;
+};
+
+/**
+ * @brief k lowest eigenpairs of a symmetric operator (block Davidson)
+ *
+ * Each iteration solves the projected problem V^T A V with eigsym(), then
+ * expands V with the diagonally preconditioned residuals
+ * t = (theta - diag(A))^-1 r of the unconverged Ritz pairs. When V reaches
+ * max_subspace it is collapsed onto the lowest Ritz vectors. Memory is
+ * O(n * max_subspace); only `apply` ever sees the operator.
+ *
+ * @param apply     block product with the operator
+ * @param diagonal  diagonal of the operator, its length gives n
+ * @param k         number of eigenpairs, 1 <= k <= n
+ * @throws InvalidMatrixSize if k, max_subspace or the guess do not fit n,
+ *         or `apply` returns a block of the wrong shape
+ * @throws std::runtime_error if tol is not reached within max_iterations
+ */
+DavidsonResult davidson(const BlockOperator& apply, const vec& diagonal, index_t k,
+                        const DavidsonOptions& options = {});
+
+/**
+ * @brief k lowest eigenpairs of a symmetric Matrix (block Davidson)
+ *
+ * @throws InvalidMatrixSize if A is not square or not symmetric
+ */
+DavidsonResult davidson(const Matrix& A, index_t k, const DavidsonOptions& options = {});
+
+/**
+ * @brief k lowest eigenpairs of a symmetric SparseMatrix (block Davidson)
+ *
+ * Each block product costs O(nnz * block size), so memory and time stay
+ * linear in the number of stored entries.
+ *
+ * @throws InvalidMatrixSize if A is not square or not symmetric
+ */
+DavidsonResult davidson(const SparseMatrix& A, index_t k, const DavidsonOptions& options = {});
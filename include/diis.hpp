@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+#include "matrix.h"
+
+// Pulay's direct inversion in the iterative subspace (DIIS) for SCF
+// iterations. The Fock matrix of the next iteration is the combination of
+// the stored ones whose error vectors combine to the smallest norm.
+
+/**
+ * @class DIIS
+ * @brief DIIS convergence accelerator keeping the last max_vectors Fock and
+ *        error matrices
+ *
+ * Fock and error matrices live in a ring buffer whose slots are allocated by
+ * the first max_vectors calls and overwritten in place after that. The
+ * Gram matrix B(i, j) = <e_i, e_j> is kept across calls, so each
+ * extrapolate() computes only the inner products of the new error with the
+ * stored ones (one row and column of B), then solves the small system
+ *
+ *   [ B   -1 ] [ c      ]   [  0 ]
+ *   [ -1   0 ] [ lambda ] = [ -1 ]
+ *
+ * with LUFactor and writes sum_i c_i F_i over the caller's Fock matrix.
+ *
+ * Typical loop:
+ * @code
+ * DIIS diis(8);
+ * for (...) {
+ *   Matrix F = build_fock(D);
+ *   diis.extrapolate(F, DIIS::commutator(F, D, S));
+ *   D = density_from(F);
+ * }
+ * @endcode
+ */
+class DIIS {
+ public:
+  /**
+   * @param max_vectors  size of the subspace, at least 1
+   * @throws std::invalid_argument if max_vectors < 1
+   */
+  explicit DIIS(index_t max_vectors = 8);
+
+  /**
+   * @brief Stores F and its error, replacing the oldest pair once full, and
+   *        overwrites F with the extrapolated Fock matrix
+   *
+   * When the subspace system is singular (linearly dependent errors), the
+   * oldest vectors are dropped until it is not.
+   *
+   * @throws InvalidMatrixSize if F and error differ in shape, or from the
+   *         matrices already stored
+   */
+  void extrapolate(Matrix& F, const Matrix& error);
+
+  /**
+   * @brief Number of stored Fock/error pairs
+   */
+  index_t size() const;
+  index_t max_vectors() const;
+  /**
+   * @brief Coefficients of the last extrapolation, oldest vector first;
+   *        they sum to 1
+   */
+  const vec& coefficients() const;
+  /**
+   * @brief Frobenius norm of the last error passed to extrapolate()
+   */
+  double error_norm() const;
+  /**
+   * @brief Forgets the stored vectors, keeping the allocated slots
+   */
+  void reset();
+
+  /**
+   * @brief The usual SCF error F D S - S D F, from one product chain:
+   *        with symmetric F, D and S it is X - X^T for X = F D S
+   */
+  static Matrix commutator(const Matrix& F, const Matrix& D, const Matrix& S);
+
+ private:
+  // slot of the i-th stored vector, oldest first
+  index_t slot(index_t i) const;
+
+  index_t capacity;
+  std::vector<Matrix> focks;
+  std::vector<Matrix> errors;
+  Matrix B;           // B(s, t) = <e_s, e_t> by slot
+  index_t count = 0;  // stored pairs
+  index_t next = 0;   // slot written by the next extrapolate()
+  vec coeffs;
+};
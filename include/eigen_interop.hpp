@@ -0,0 +1,95 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <stdexcept>
+#include "matrix.h"
+
+// Eigen maps share a Matrix buffer in either layout: row-major matrices map
+// to RowMajorMatrixXd, column-major ones to Eigen's default MatrixXd, both
+// with the same shape. The *_transposed function reads a column-major Eigen
+// buffer as a row-major Matrix, which is the transpose.
+
+/**
+ * @brief Dynamic row-major Eigen matrix, the default layout of Matrix
+ */
+using RowMajorMatrixXd = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+/**
+ * @brief Eigen map over a row-major M's buffer with the same shape, no copy
+ * @throws std::runtime_error if M is column-major
+ */
+inline Eigen::Map<RowMajorMatrixXd> eigen_view(Matrix& M) {
+  if (M.get_layout() != Layout::RowMajor) {
+    throw std::runtime_error("eigen_view requires a row-major Matrix, see eigen_view_colmajor");
+  }
+  return Eigen::Map<RowMajorMatrixXd>(M.memptr(), M.get_num_rows(), M.get_num_cols());
+}
+
+inline Eigen::Map<const RowMajorMatrixXd> eigen_view(const Matrix& M) {
+  if (M.get_layout() != Layout::RowMajor) {
+    throw std::runtime_error("eigen_view requires a row-major Matrix, see eigen_view_colmajor");
+  }
+  return Eigen::Map<const RowMajorMatrixXd>(M.memptr(), M.get_num_rows(), M.get_num_cols());
+}
+
+/**
+ * @brief Eigen map over a column-major M's buffer with the same shape, no copy
+ * @throws std::runtime_error if M is row-major
+ */
+inline Eigen::Map<Eigen::MatrixXd> eigen_view_colmajor(Matrix& M) {
+  if (M.get_layout() != Layout::ColMajor) {
+    throw std::runtime_error("eigen_view_colmajor requires a column-major Matrix");
+  }
+  return Eigen::Map<Eigen::MatrixXd>(M.memptr(), M.get_num_rows(), M.get_num_cols());
+}
+
+inline Eigen::Map<const Eigen::MatrixXd> eigen_view_colmajor(const Matrix& M) {
+  if (M.get_layout() != Layout::ColMajor) {
+    throw std::runtime_error("eigen_view_colmajor requires a column-major Matrix");
+  }
+  return Eigen::Map<const Eigen::MatrixXd>(M.memptr(), M.get_num_rows(), M.get_num_cols());
+}
+
+/**
+ * @brief Non-owning row-major Matrix over a row-major Eigen matrix, same shape
+ *
+ * A must outlive the returned matrix and must not be resized meanwhile.
+ */
+inline Matrix adopt_eigen(RowMajorMatrixXd& A) {
+  return Matrix::adopt(A.data(), static_cast<index_t>(A.rows()), static_cast<index_t>(A.cols()));
+}
+
+/**
+ * @brief Non-owning column-major Matrix over a column-major Eigen matrix, same shape
+ */
+inline Matrix adopt_eigen(Eigen::MatrixXd& A) {
+  return Matrix::adopt(A.data(), static_cast<index_t>(A.rows()), static_cast<index_t>(A.cols()),
+                       Layout::ColMajor);
+}
+
+/**
+ * @brief Non-owning row-major Matrix over a column-major Eigen matrix, holding A^T
+ */
+inline Matrix adopt_eigen_transposed(Eigen::MatrixXd& A) {
+  return Matrix::adopt(A.data(), static_cast<index_t>(A.cols()), static_cast<index_t>(A.rows()));
+}
+
+/**
+ * @brief Copy of M as a column-major Eigen matrix of the same shape
+ */
+inline Eigen::MatrixXd to_eigen(const Matrix& M) {
+  if (M.get_layout() == Layout::ColMajor) {
+    return eigen_view_colmajor(M);
+  }
+  return eigen_view(M);
+}
+
+/**
+ * @brief Copy of A as a row-major Matrix of the same shape
+ */
+template <typename Derived>
+Matrix from_eigen(const Eigen::MatrixBase<Derived>& A) {
+  Matrix M(static_cast<index_t>(A.rows()), static_cast<index_t>(A.cols()));
+  eigen_view(M) = A;
+  return M;
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <vector>
+#include "matrix.h"
+
+// Linear solves through triangular factorizations. A factor object is
+// computed once, O(n^3), and then solves any number of right-hand sides at
+// O(n^2) each, which is far cheaper than going through eigsym() for S x = b
+// or S^-1.
+
+/**
+ * @brief Which triangle of a matrix holds a triangular factor
+ */
+enum class Triangle {
+  Lower,
+  Upper
+};
+
+/**
+ * @brief Solves op(T) X = B for triangular T, with op(T) = T or T^T
+ *
+ * Only the `uplo` triangle of T is read (and not its diagonal when
+ * unit_diagonal is set). All columns of B are solved together, split
+ * across the worker threads, so many right-hand sides cost little more per
+ * column than one.
+ *
+ * @throws InvalidMatrixSize if T is not square or B has the wrong number of rows
+ */
+Matrix solve_triangular(const Matrix& T, const Matrix& B, Triangle uplo,
+                        bool transpose = false, bool unit_diagonal = false);
+
+/**
+ * @brief solve_triangular() for a single right-hand side
+ */
+vec solve_triangular(const Matrix& T, const vec& b, Triangle uplo,
+                     bool transpose = false, bool unit_diagonal = false);
+
+/**
+ * @class CholeskyFactor
+ * @brief Cholesky factorization A = U^T U of a symmetric positive definite matrix
+ *
+ * Blocked, upper form: each block row is factored, the panel to its right is
+ * solved with a multi-RHS triangular solve, and the trailing matrix takes a
+ * rank-64 update (dsyrk on the BLAS backend, row-parallel otherwise), so
+ * almost all of the n^3 / 3 flops run in the level-3 update.
+ */
+class CholeskyFactor {
+ public:
+  /**
+   * @brief Factors A, reading its upper triangle
+   *
+   * @param check_symmetric  reject A unless it is symmetric to 1e-8
+   * @throws InvalidMatrixSize if A is not square, or not symmetric when checked
+   * @throws std::domain_error if A is not positive definite
+   */
+  explicit CholeskyFactor(const Matrix& A, bool check_symmetric = true);
+
+  index_t size() const;
+  /**
+   * @brief U, row-major with zeros below the diagonal
+   */
+  const Matrix& upper() const;
+  /**
+   * @brief L = U^T, so that A = L L^T
+   */
+  Matrix lower() const;
+
+  /**
+   * @brief Solves A X = B for all columns of B at once
+   * @throws InvalidMatrixSize if B does not have size() rows
+   */
+  Matrix solve(const Matrix& B) const;
+  vec solve(const vec& b) const;
+  /**
+   * @brief A^-1, symmetric
+   */
+  Matrix inverse() const;
+  /**
+   * @brief log(det(A)) = 2 sum log(u_ii), which does not overflow for large n
+   */
+  double log_det() const;
+
+ private:
+  Matrix U;
+};
+
+/**
+ * @class LDLTFactor
+ * @brief Pivoted factorization P A P^T = L D L^T of a symmetric, possibly
+ *        indefinite matrix
+ *
+ * Bunch-Kaufman pivoting: D is block diagonal with 1x1 and 2x2 blocks and L
+ * is unit lower triangular. The pivots bound the element growth of the
+ * reduced matrices, so any nonsingular symmetric A can be factored, unlike
+ * with Cholesky. Costs n^3 / 3 flops; the rank-1 and rank-2 updates of the
+ * trailing matrix are split by rows across the worker threads.
+ */
+class LDLTFactor {
+ public:
+  /**
+   * @brief Factors A, reading its lower triangle
+   *
+   * @param check_symmetric  reject A unless it is symmetric to 1e-8
+   * @throws InvalidMatrixSize if A is not square, or not symmetric when checked
+   * @throws std::runtime_error if A is singular
+   */
+  explicit LDLTFactor(const Matrix& A, bool check_symmetric = true);
+
+  index_t size() const;
+  /**
+   * @brief L, unit lower triangular, row-major
+   */
+  const Matrix& lower() const;
+  /**
+   * @brief D, block diagonal (tridiagonal with zeros between the blocks)
+   */
+  Matrix block_diagonal() const;
+  /**
+   * @brief Row i of P A P^T is row permutation()[i] of A
+   */
+  const std::vector<index_t>& permutation() const;
+
+  /**
+   * @brief Solves A X = B for all columns of B at once
+   * @throws InvalidMatrixSize if B does not have size() rows
+   */
+  Matrix solve(const Matrix& B) const;
+  vec solve(const vec& b) const;
+  /**
+   * @brief A^-1, symmetric
+   */
+  Matrix inverse() const;
+  /**
+   * @brief Number of negative eigenvalues of A (Sylvester's law of inertia)
+   */
+  index_t num_negative() const;
+
+ private:
+  Matrix L;
+  vec d;                     // diagonal of D
+  vec e;                     // subdiagonal of D, nonzero inside 2x2 blocks only
+  std::vector<index_t> perm;
+};
+
+/**
+ * @class LUFactor
+ * @brief LU factorization with partial pivoting, P A = L U, of a general
+ *        square matrix
+ *
+ * Blocked, right-looking: each 64-column panel is factored with row
+ * interchanges, the block row of U to its right is a unit lower triangular
+ * solve, and the trailing matrix takes a rank-64 GEMM update (dgemm on the
+ * BLAS backend, the blocked native GEMM otherwise), which holds nearly all
+ * of the 2 n^3 / 3 flops.
+ */
+class LUFactor {
+ public:
+  /**
+   * @brief Factors A
+   *
+   * A singular A still factors (with a zero on the diagonal of U); det()
+   * then returns 0 and solve() throws.
+   *
+   * @throws InvalidMatrixSize if A is not square
+   */
+  explicit LUFactor(const Matrix& A);
+
+  index_t size() const;
+  /**
+   * @brief L, unit lower triangular, row-major
+   */
+  Matrix lower() const;
+  /**
+   * @brief U, upper triangular, row-major
+   */
+  Matrix upper() const;
+  /**
+   * @brief Row i of P A is row permutation()[i] of A
+   */
+  const std::vector<index_t>& permutation() const;
+
+  /**
+   * @brief Solves A X = B for all columns of B at once
+   * @throws InvalidMatrixSize if B does not have size() rows
+   * @throws std::runtime_error if A is singular
+   */
+  Matrix solve(const Matrix& B) const;
+  vec solve(const vec& b) const;
+  /**
+   * @brief A^-1
+   * @throws std::runtime_error if A is singular
+   */
+  Matrix inverse() const;
+  /**
+   * @brief det(A), the signed product of the diagonal of U
+   */
+  double det() const;
+
+ private:
+  Matrix LU;                 // L below the diagonal (unit diagonal implied), U on and above
+  std::vector<index_t> perm;
+  int parity = 1;            // sign of the permutation
+};
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include "matrix.h"
+
+// Small matrices whose shape is part of the type. Storage is a row-major
+// std::array on the stack, so a FixedMatrix never allocates, and every loop
+// below has a compile-time trip count. The products and transposes are
+// spelled out with index_sequence folds, which expand to straight-line code
+// for any shape rather than relying on the optimizer to unroll.
+
+namespace fixed_detail {
+
+// calls f(std::integral_constant<int, I>) for I = 0 .. N-1, fully expanded
+template <typename F, int... I>
+constexpr void unroll(F&& f, std::integer_sequence<int, I...>) {
+  (f(std::integral_constant<int, I>{}), ...);
+}
+
+template <int N, typename F>
+constexpr void unroll(F&& f) {
+  unroll(std::forward<F>(f), std::make_integer_sequence<int, N>{});
+}
+
+} // namespace fixed_detail
+
+/**
+ * @class FixedMatrix
+ * @brief R x C matrix with compile-time dimensions and stack storage
+ *
+ * Meant for 2x2 .. 4x4 geometry work (rotations, inertia tensors, small
+ * eigensolves) where a heap-allocated Matrix costs more than the arithmetic.
+ * Shape mismatches are compile errors; conversions to and from Matrix check
+ * the runtime shape.
+ */
+template <int R, int C>
+class FixedMatrix {
+  static_assert(R > 0 && C > 0, "FixedMatrix dimensions must be positive");
+
+private:
+  std::array<double, R * C> data{};
+
+public:
+  /**
+   * @brief Zero-initialized matrix
+   */
+  constexpr FixedMatrix() = default;
+
+  /**
+   * @brief Matrix from R * C values in row-major order
+   */
+  constexpr explicit FixedMatrix(const std::array<double, R * C>& values) : data(values) {}
+
+  /**
+   * @brief Copy of a runtime Matrix of the same shape, in either layout
+   * @throws InvalidMatrixSize if M is not R x C
+   */
+  explicit FixedMatrix(const Matrix& M) {
+    if (M.get_num_rows() != R || M.get_num_cols() != C) {
+      throw InvalidMatrixSize("FixedMatrix: Matrix shape does not match");
+    }
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) {
+        data[i * C + j] = M(i, j);
+      }
+    }
+  }
+
+  static constexpr FixedMatrix Zeros() { return FixedMatrix(); }
+
+  static constexpr FixedMatrix Ones() {
+    FixedMatrix M;
+    for (double& x : M.data) {
+      x = 1.0;
+    }
+    return M;
+  }
+
+  static constexpr FixedMatrix Identity() {
+    static_assert(R == C, "Identity requires a square FixedMatrix");
+    FixedMatrix M;
+    for (int i = 0; i < R; i++) {
+      M(i, i) = 1.0;
+    }
+    return M;
+  }
+
+  static constexpr int rows() { return R; }
+  static constexpr int cols() { return C; }
+  static constexpr int size() { return R * C; }
+
+  /**
+   * @brief Unchecked element access; use at() for a bounds check
+   */
+  constexpr double& operator()(int i, int j) { return data[i * C + j]; }
+  constexpr const double& operator()(int i, int j) const { return data[i * C + j]; }
+
+  /**
+   * @brief Element access by flat row-major index, convenient for vectors
+   */
+  constexpr double& operator[](int k) { return data[k]; }
+  constexpr const double& operator[](int k) const { return data[k]; }
+
+  /**
+   * @brief Bounds-checked element access
+   * @throws std::out_of_range if (i, j) is outside the matrix
+   */
+  double& at(int i, int j) {
+    if (i < 0 || i >= R || j < 0 || j >= C) {
+      throw std::out_of_range("FixedMatrix index out of range");
+    }
+    return data[i * C + j];
+  }
+
+  const double& at(int i, int j) const {
+    if (i < 0 || i >= R || j < 0 || j >= C) {
+      throw std::out_of_range("FixedMatrix index out of range");
+    }
+    return data[i * C + j];
+  }
+
+  constexpr double* memptr() { return data.data(); }
+  constexpr const double* memptr() const { return data.data(); }
+
+  /**
+   * @brief Copy into a heap-allocated Matrix in the requested layout
+   */
+  Matrix to_matrix(Layout layout = Layout::RowMajor) const {
+    Matrix M(vec(data.begin(), data.end()), R, C);
+    return layout == Layout::RowMajor ? M : M.to_layout(layout);
+  }
+
+  operator Matrix() const { return to_matrix(); }
+
+  constexpr FixedMatrix operator+(const FixedMatrix& other) const {
+    FixedMatrix S;
+    fixed_detail::unroll<R * C>([&](auto k) { S.data[k] = data[k] + other.data[k]; });
+    return S;
+  }
+
+  constexpr FixedMatrix operator-(const FixedMatrix& other) const {
+    FixedMatrix S;
+    fixed_detail::unroll<R * C>([&](auto k) { S.data[k] = data[k] - other.data[k]; });
+    return S;
+  }
+
+  constexpr FixedMatrix operator*(double s) const {
+    FixedMatrix S;
+    fixed_detail::unroll<R * C>([&](auto k) { S.data[k] = data[k] * s; });
+    return S;
+  }
+
+  /**
+   * @brief Product with a C x K matrix, one fully expanded dot per element
+   */
+  template <int K>
+  constexpr FixedMatrix<R, K> operator*(const FixedMatrix<C, K>& B) const {
+    FixedMatrix<R, K> P;
+    fixed_detail::unroll<R>([&](auto i) {
+      fixed_detail::unroll<K>([&](auto j) {
+        double sum = 0.0;
+        fixed_detail::unroll<C>([&](auto k) { sum += (*this)(i, k) * B(k, j); });
+        P(i, j) = sum;
+      });
+    });
+    return P;
+  }
+
+  constexpr FixedMatrix<C, R> transpose() const {
+    FixedMatrix<C, R> T;
+    fixed_detail::unroll<R>([&](auto i) {
+      fixed_detail::unroll<C>([&](auto j) { T(j, i) = (*this)(i, j); });
+    });
+    return T;
+  }
+
+  constexpr double trace() const {
+    static_assert(R == C, "trace requires a square FixedMatrix");
+    double sum = 0.0;
+    fixed_detail::unroll<R>([&](auto i) { sum += (*this)(i, i); });
+    return sum;
+  }
+
+  double norm_fro() const {
+    double sum = 0.0;
+    fixed_detail::unroll<R * C>([&](auto k) { sum += data[k] * data[k]; });
+    return std::sqrt(sum);
+  }
+
+  double max_abs() const {
+    double m = 0.0;
+    for (double x : data) {
+      m = std::max(m, std::abs(x));
+    }
+    return m;
+  }
+
+  /**
+   * @brief True if |A(i,j) - A(j,i)| <= tol for all i, j
+   */
+  bool is_symmetric(double tol = 1e-12) const {
+    if (R != C) {
+      return false;
+    }
+    for (int i = 0; i < R; i++) {
+      for (int j = i + 1; j < C; j++) {
+        if (!(std::abs((*this)(i, j) - (*this)(j, i)) <= tol)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+};
+
+/**
+ * @brief Column vector with a compile-time length
+ */
+template <int N>
+using FixedVector = FixedMatrix<N, 1>;
+
+using Matrix2 = FixedMatrix<2, 2>;
+using Matrix3 = FixedMatrix<3, 3>;
+using Matrix4 = FixedMatrix<4, 4>;
+using Vector3 = FixedVector<3>;
+
+template <int R, int C>
+constexpr FixedMatrix<R, C> operator*(double s, const FixedMatrix<R, C>& A) {
+  return A * s;
+}
+
+/**
+ * @brief Sum of elementwise products, x . y for vectors
+ */
+template <int R, int C>
+constexpr double dot(const FixedMatrix<R, C>& A, const FixedMatrix<R, C>& B) {
+  double sum = 0.0;
+  fixed_detail::unroll<R * C>([&](auto k) { sum += A[k] * B[k]; });
+  return sum;
+}
+
+/**
+ * @brief Eigen decomposition of a symmetric FixedMatrix
+ */
+template <int N>
+struct FixedEigsymResult {
+  std::array<double, N> eigenvalues; // ascending
+  FixedMatrix<N, N> eigenvectors;    // one eigenvector per column
+};
+
+/**
+ * @brief Eigenvalues and eigenvectors of a small symmetric matrix (cyclic Jacobi)
+ *
+ * Each rotation zeroes one off-diagonal pair exactly, so small matrices
+ * converge in a handful of sweeps to full accuracy, including for repeated
+ * eigenvalues where closed-form 3x3 formulas lose digits. Only the upper
+ * triangle is read. Follows Numerical Recipes, 3rd ed., section 11.1.
+ *
+ * @throws InvalidMatrixSize if check_symmetric is set and S is not symmetric
+ * @throws std::runtime_error if the sweeps do not converge
+ */
+template <int N>
+FixedEigsymResult<N> eigsym(const FixedMatrix<N, N>& S, bool check_symmetric = true) {
+  if (check_symmetric && !S.is_symmetric(1e-8)) {
+    throw InvalidMatrixSize("FixedMatrix must be symmetric for eigsym()");
+  }
+
+  FixedMatrix<N, N> a = S;
+  FixedMatrix<N, N> v = FixedMatrix<N, N>::Identity();
+  std::array<double, N> d{};
+  std::array<double, N> b{};
+  std::array<double, N> z{};
+  for (int i = 0; i < N; i++) {
+    d[i] = b[i] = a(i, i);
+  }
+
+  // rotates the pair (a(i,j), a(k,l)) in place
+  auto rotate = [](FixedMatrix<N, N>& m, double s, double tau, int i, int j, int k, int l) {
+    double g = m(i, j);
+    double h = m(k, l);
+    m(i, j) = g - s * (h + g * tau);
+    m(k, l) = h + s * (g - h * tau);
+  };
+
+  bool converged = false;
+  for (int sweep = 1; sweep <= 50; sweep++) {
+    double off = 0.0;
+    for (int p = 0; p < N - 1; p++) {
+      for (int q = p + 1; q < N; q++) {
+        off += std::abs(a(p, q));
+      }
+    }
+    // relies on underflow to an exact zero, as in the reference algorithm
+    if (off == 0.0) {
+      converged = true;
+      break;
+    }
+
+    // skip tiny elements during the first sweeps
+    double tresh = sweep < 4 ? 0.2 * off / (N * N) : 0.0;
+
+    for (int p = 0; p < N - 1; p++) {
+      for (int q = p + 1; q < N; q++) {
+        double g = 100.0 * std::abs(a(p, q));
+        if (sweep > 4 && std::abs(d[p]) + g == std::abs(d[p]) &&
+            std::abs(d[q]) + g == std::abs(d[q])) {
+          a(p, q) = 0.0;
+        } else if (std::abs(a(p, q)) > tresh) {
+          double h = d[q] - d[p];
+          double t;
+          if (std::abs(h) + g == std::abs(h)) {
+            t = a(p, q) / h;
+          } else {
+            double theta = 0.5 * h / a(p, q);
+            t = 1.0 / (std::abs(theta) + std::sqrt(1.0 + theta * theta));
+            if (theta < 0.0) {
+              t = -t;
+            }
+          }
+          double c = 1.0 / std::sqrt(1.0 + t * t);
+          double s = t * c;
+          double tau = s / (1.0 + c);
+          h = t * a(p, q);
+          z[p] -= h;
+          z[q] += h;
+          d[p] -= h;
+          d[q] += h;
+          a(p, q) = 0.0;
+          for (int j = 0; j < p; j++) {
+            rotate(a, s, tau, j, p, j, q);
+          }
+          for (int j = p + 1; j < q; j++) {
+            rotate(a, s, tau, p, j, j, q);
+          }
+          for (int j = q + 1; j < N; j++) {
+            rotate(a, s, tau, p, j, q, j);
+          }
+          for (int j = 0; j < N; j++) {
+            rotate(v, s, tau, j, p, j, q);
+          }
+        }
+      }
+    }
+    // fold the accumulated updates back into d to limit rounding drift
+    for (int p = 0; p < N; p++) {
+      b[p] += z[p];
+      d[p] = b[p];
+      z[p] = 0.0;
+    }
+  }
+  if (!converged) {
+    throw std::runtime_error("FixedMatrix eigsym: Jacobi sweeps did not converge");
+  }
+
+  // ascending insertion sort, moving eigenvector columns along
+  for (int i = 1; i < N; i++) {
+    double w = d[i];
+    FixedVector<N> col;
+    for (int r = 0; r < N; r++) {
+      col[r] = v(r, i);
+    }
+    int j = i - 1;
+    for (; j >= 0 && d[j] > w; j--) {
+      d[j + 1] = d[j];
+      for (int r = 0; r < N; r++) {
+        v(r, j + 1) = v(r, j);
+      }
+    }
+    d[j + 1] = w;
+    for (int r = 0; r < N; r++) {
+      v(r, j + 1) = col[r];
+    }
+  }
+
+  return {d, v};
+}
@@ -2,13 +2,18 @@
 
 #include <iostream>
 #include <vector>
+#include <memory>
+#include <cstdint>
 #include <limits>
 #include "custom_exception.hpp"
 #include "helper_func.hpp" // numerical recipes helper functions
+#include "parallel.hpp"
+#include "backend.hpp"
 #include <cmath>
 #include <iomanip>
 #include <stdexcept>
 #include <random>
+#include <string>
 
 /**
  * @mainpage MatrixLibrary
@@ -22,9 +27,29 @@
  * - Matrix arithmetic
  * - Householder tridiagonalization
  * - QL eigenvalue solver
+ * - Parallel round-robin Jacobi eigenvalue solver
+ * - Warm-started eigensolver refining a previous decomposition
+ * - Symmetric matrix functions (sqrt, inverse sqrt, exp, log, any f)
+ * - Block Davidson solver for the lowest eigenpairs (davidson.hpp)
+ * - Diagonalization-free density matrices by TC2 purification (purification.hpp)
+ * - Cholesky, pivoted LDL^T, LU and triangular solves (factorizations.hpp)
+ * - DIIS convergence acceleration for SCF iterations (diis.hpp)
  * - Symmetry Check
  * - Transpose
  * - HDF5 output
+ * - Fast delimited text input/output
+ * - Parallel elementwise kernels and reductions (map, zip, reduce)
+ * - Diagonal matrices with O(n^2) scaling products
+ * - CSR sparse matrices with drop-tolerance conversion and parallel products
+ * - Lazy transposes consumed by transposed-operand GEMM kernels
+ * - Optional BLAS/LAPACK backend for products and eigsym
+ * - Zero-copy Armadillo and Eigen adapters
+ * - Row-major or column-major storage, mixed freely
+ * - Compile-time sized FixedMatrix for allocation-free small matrices
+ * - Opt-in copy-on-write storage for O(1) read-only copies
+ * - 64-bit dimensions and indices
+ * - Reproducible parallel random matrices (Philox4x32-10)
+ * - Uninitialized and calloc-backed construction tags
  */
 
 /**
@@ -32,6 +57,78 @@
 */
 typedef std::vector<double> vec;
 
+/**
+ * @brief Signed 64-bit type for matrix dimensions, element counts and indices
+ *
+ * rows * cols and flat offsets exceed the int range past 46340 x 46340.
+ */
+typedef std::int64_t index_t;
+
+/**
+ * @brief Field separator used when reading and writing text matrices
+ */
+enum class TextFormat {
+  Whitespace, // columns separated by spaces (any run of spaces/tabs when reading)
+  CSV,        // comma separated values
+  TSV         // tab separated values
+};
+
+/**
+ * @brief Storage order of a Matrix
+ *
+ * RowMajor keeps rows contiguous (element (i, j) at i * cols + j), ColMajor
+ * keeps columns contiguous (at i + j * rows) like Armadillo, Eigen's default
+ * and Fortran/LAPACK. Every operation accepts either layout and operands of
+ * different layouts; kernels read each one in its own storage order.
+ */
+enum class Layout {
+  RowMajor,
+  ColMajor
+};
+
+/**
+ * @brief Algorithm used by Matrix::eigsym
+ *
+ * Default is LAPACK dsyevd on the Blas backend and HouseholderQL otherwise.
+ * Jacobi runs cyclic two-sided Jacobi sweeps in round-robin order, rotating
+ * n/2 disjoint pairs at a time across the worker threads. It does more work
+ * than HouseholderQL on large dense matrices, but it keeps the small
+ * eigenvalues of graded positive definite matrices to high relative
+ * accuracy and needs only one or two sweeps on a nearly diagonal matrix.
+ */
+enum class EigsymMethod {
+  Default,
+  HouseholderQL,
+  Jacobi
+};
+
+/**
+ * @class DataView
+ * @brief Read-only view of a matrix's elements in storage order, returned by
+ *        Matrix::get_data()
+ *
+ * Points into the matrix: no copy is made, and the view is valid while the
+ * matrix lives and is not resized or reassigned.
+ */
+class DataView {
+private:
+  const double* first;
+  index_t count;
+
+public:
+  DataView(const double* data, index_t size) : first(data), count(size) {}
+
+  const double* data() const { return first; }
+  index_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  const double* begin() const { return first; }
+  const double* end() const { return first + count; }
+  double operator[](index_t i) const { return first[i]; }
+};
+
+class DiagonalMatrix;
+class TransposeView;
+
 // Forward declarations of global result types
 struct TridiagonalResult;
 struct EigsymResult;
@@ -48,50 +145,177 @@ struct QLEigenResult;
  */
 class Matrix {
 private:
-  int num_rows;
-  int num_cols;
-  int size;
-  vec matrix;
+  index_t num_rows;
+  index_t num_cols;
+  index_t size;
+  // owned buffer from calloc/malloc, or aliasing a vec moved in by the
+  // constructor; null for a matrix adopting external memory
+  std::shared_ptr<double> storage;
+  double* mem = nullptr;        // first element, storage.get() or the adopted buffer
+  Layout layout = Layout::RowMajor;
+  bool cow = false;             // copies share storage until one of them writes
+
+  // give this matrix its own buffer before a write if the storage is shared
+  void detach() {
+    if (cow && storage.use_count() > 1) {
+      clone_storage();
+    }
+  }
+  void clone_storage();
+
+  // position of element (x, y) in the buffer
+  index_t offset(index_t x, index_t y) const {
+    return layout == Layout::RowMajor ? x * num_cols + y : y * num_rows + x;
+  }
+
+  // copy other into the adopted buffer (same shape), converting the layout
+  void write_adopted(const Matrix& other);
 
 public:
+  /**
+   * @brief Construction tag: the elements are left unset (malloc), for
+   *        results that are written in full before being read
+   */
+  struct Uninitialized { explicit Uninitialized() = default; };
+  static constexpr Uninitialized uninitialized{};
+
+  /**
+   * @brief Construction tag: the elements are zero (calloc), which for large
+   *        matrices maps fresh zero pages instead of writing the memory
+   */
+  struct Zeroed { explicit Zeroed() = default; };
+  static constexpr Zeroed zeroed{};
+
   // === Constructors ===
   /**
-   * @brief Construct a matrix of size (row * cols)
+   * @brief Construct a zero matrix of size (row * cols) in the given layout,
+   *        same as the Matrix::zeroed tag
+   */
+  Matrix(index_t rows, index_t cols, Layout layout = Layout::RowMajor);
+  Matrix(index_t rows, index_t cols, Zeroed, Layout layout = Layout::RowMajor);
+  /**
+   * @brief Construct a matrix whose elements are indeterminate until written
    */
-  Matrix(int rows, int cols);
+  Matrix(index_t rows, index_t cols, Uninitialized, Layout layout = Layout::RowMajor);
   Matrix();
   /**
-   * @brief Construct a matrix of size (row * cols) with data
+   * @brief Construct a matrix of size (row * cols) with data, given in the
+   *        storage order of `layout`
+   */
+  Matrix(const vec& values, index_t rows, index_t cols, Layout layout = Layout::RowMajor);
+  Matrix(vec&& values, index_t rows, index_t cols, Layout layout = Layout::RowMajor);
+
+  /**
+   * @brief Copies own their storage, also when copying an adopted matrix;
+   *        with copy-on-write enabled they share it instead (O(1))
    */
-  Matrix(const vec& values, int rows, int cols);
-  Matrix(vec&& values, int rows, int cols);
+  Matrix(const Matrix& other);
+  Matrix(Matrix&& other) noexcept;
+
+  /**
+   * @brief Assignment; a matrix adopting external memory keeps writing into
+   *        that memory when the shapes match, so results can land directly
+   *        in another library's buffer
+   */
+  Matrix& operator=(const Matrix& other);
+  Matrix& operator=(Matrix&& other) noexcept;
 
   // === Factory Methods ===
   /**
    * @brief Fill matrix of specified size with 1's
    */
-  static Matrix Ones(int rows, int cols);
+  static Matrix Ones(index_t rows, index_t cols);
 
   /**
    * @brief Fill matrix of specified size with 0's
    */
-  static Matrix Zeros(int rows, int cols);
+  static Matrix Zeros(index_t rows, index_t cols);
 
   /**
    * @brief Fill matrix of specific size with random doubles from [0.0, 1.0)
+   *
+   * Every call draws a fresh stream of a generator seeded once per process,
+   * so results differ between calls and runs. Use the seeded overload for
+   * reproducible matrices.
    */
-  static Matrix Random(int rows, int cols);
+  static Matrix Random(index_t rows, index_t cols);
+
+  /**
+   * @brief Reproducible random doubles from [0.0, 1.0) for (seed, stream)
+   *
+   * Uses the counter-based Philox4x32-10 generator: element k (in storage
+   * order) is a pure function of (seed, stream, k), so blocks are filled in
+   * parallel and the result does not depend on the thread count. Different
+   * streams under one seed are independent, e.g. one per trial vector or MPI
+   * rank.
+   */
+  static Matrix Random(index_t rows, index_t cols, std::uint64_t seed, std::uint64_t stream = 0);
 
   /**
    * @brief Create square identity matrix with dimensions n*n
    */
-  static Matrix Identity(int n);
+  static Matrix Identity(index_t n);
+
+  /**
+   * @brief Non-owning matrix over external memory, no copy is made
+   *
+   * The buffer is read in the storage order of `layout`, so column-major
+   * buffers (Armadillo, default Eigen, Fortran) are adopted with
+   * Layout::ColMajor. The caller keeps the buffer alive for the lifetime of
+   * the matrix; writes through the matrix modify it. See arma_interop.hpp and
+   * eigen_interop.hpp.
+   */
+  static Matrix adopt(double* data, index_t rows, index_t cols, Layout layout = Layout::RowMajor);
 
   // === Accessors ===
-  int get_num_rows() const;
-  int get_num_cols() const;
-  int get_size() const;
-  const vec& get_data() const;
+  index_t get_num_rows() const;
+  index_t get_num_cols() const;
+  index_t get_size() const;
+  /**
+   * @brief View of the elements in storage order (see get_layout), no copy
+   */
+  DataView get_data() const;
+  /**
+   * @brief Copy of the elements in row-major order, whatever the layout
+   */
+  vec copy_data() const;
+  /**
+   * @brief Pointer to the elements in storage order (see get_layout),
+   *        valid while the matrix lives
+   */
+  double* memptr();
+  const double* memptr() const;
+  Layout get_layout() const;
+  /**
+   * @brief Copy of the matrix stored in `target` layout
+   */
+  Matrix to_layout(Layout target) const;
+  /**
+   * @brief False if the matrix was created by adopt() over external memory
+   */
+  bool owns_memory() const;
+
+  // === Copy-on-write ===
+  /**
+   * @brief Opt in to (or out of) copy-on-write storage
+   *
+   * With copy-on-write enabled, copies and copy assignments of this matrix
+   * share its reference-counted buffer in O(1) time and memory instead of
+   * copying it; the setting travels with the copies. A matrix clones the
+   * shared buffer on its first mutable access: the non-const operator() or
+   * memptr(), or any function taking it by non-const reference. Reads through
+   * a const matrix never copy. A reference or pointer obtained before the
+   * matrix is copied again keeps writing into the shared buffer, so take it
+   * after the last copy. Adopted matrices are always copied.
+   *
+   * Disabling gives the matrix its own buffer if it currently shares one.
+   */
+  void set_copy_on_write(bool enabled = true);
+  bool copy_on_write() const;
+  /**
+   * @brief True if both matrices currently read the same owned buffer
+   */
+  bool shares_storage_with(const Matrix& other) const;
 
   // === Operators ===
   /**
@@ -100,37 +324,392 @@ public:
    * @param x row index (0-based)
    * @param y column index (0-based)
    * @return reference to the matrix element
+   *
+   * Clones a shared copy-on-write buffer first, see set_copy_on_write.
    * 
    * @throws OutofBounds exception if the indices are invalid
    */
-  double& operator()(int x, int y);
+  double& operator()(index_t x, index_t y);
 
   /**
    * @brief Const reference to the matrix element at (row, col)
    */
-  const double& operator()(int x, int y) const;
+  const double& operator()(index_t x, index_t y) const;
   
+  /**
+   * @brief Elementwise comparison with the default tolerances of approx_equal
+   */
   bool operator==(const Matrix& other) const;
+  /**
+   * @brief Sums, differences and products accept operands of any layout;
+   *        the result is stored in the layout of the left operand
+   */
   Matrix operator+(const Matrix& other) const;
   Matrix operator-(const Matrix& other) const;
   Matrix operator*(const Matrix& other) const;
   Matrix operator*(double s) const;
 
+  /**
+   * @brief Matrix-vector product y = A * x (GEMV)
+   *
+   * Row-major matrices take a dot product with each contiguous row,
+   * column-major ones accumulate contiguous columns; large matrices are
+   * split across the worker threads.
+   *
+   * @throws InvalidMatrixSize if x.size() != number of columns
+   */
+  vec operator*(const vec& x) const;
+
+  /**
+   * @brief Symmetric matrix-vector product y = A * x (SYMV)
+   *
+   * Only one triangle is read, so the other may hold anything: the upper
+   * triangle (j >= i) of a row-major matrix, the lower one of a column-major
+   * matrix (the triangle stored first in each row or column). Each stored
+   * row contributes a dot product and an axpy to y.
+   *
+   * @throws InvalidMatrixSize if the matrix is not square or sizes differ
+   */
+  vec symv(const vec& x) const;
+
+  // === Elementwise Kernels and Reductions ===
+  /**
+   * @brief Apply f to every element, returning a matrix of the same shape
+   *
+   * The inner loop runs over contiguous memory so simple functions vectorize,
+   * and large matrices are split into chunks across the worker threads.
+   */
+  template <typename F>
+  Matrix map(F f) const;
+
+  /**
+   * @brief Fold all elements into one value
+   *
+   * f(acc, x) adds one element to an accumulator and combine(a, b) merges
+   * the accumulators of two chunks. Every chunk starts from init, so init
+   * must be the identity of combine. The result does not depend on the
+   * number of threads.
+   */
+  template <typename T, typename F, typename CombineF>
+  T reduce(T init, F f, CombineF combine) const;
+
+  double sum() const;
+  double norm_fro() const; // sqrt of the sum of squared elements
+  double max_abs() const;
+  double trace() const;
+
   // === Linear Algebra Functionality ===
-  static Matrix diagmat(const vec& vector);
+  /**
+   * @brief Diagonal matrix with vector[i] on the diagonal
+   *
+   * Only the n diagonal values are stored; the result converts to a dense
+   * Matrix where one is needed.
+   */
+  static DiagonalMatrix diagmat(const vec& vector);
   static Matrix diagmat(const Matrix& mat);
-  bool is_symmetric(double tol) const;
+  /**
+   * @brief Check |A(i,j) - A(j,i)| <= tol for all i, j (false if not square)
+   *
+   * Works on square tiles: each tile above the diagonal is compared with a
+   * transposed copy of its partner below the diagonal, so both are read with
+   * unit stride, and the check stops at the first tile that fails.
+   */
+  bool is_symmetric(double tol = 1e-12) const;
+  /**
+   * @brief Transposed copy of the matrix
+   */
   Matrix transpose() const;
+  /**
+   * @brief Lazy transpose, no copy is made
+   *
+   * Products, sums and differences taking the view read this matrix with
+   * transposed-operand kernels; assigning it to a Matrix materializes it.
+   * The view refers to this matrix, which must outlive it.
+   */
+  TransposeView t() const;
   TridiagonalResult householder_tridiagonalize(bool yesvecs = true) const;
   QLEigenResult QL(vec d, vec e) const;
-  EigsymResult eigsym() const;
+  /**
+   * @brief Eigenvalues (ascending) and eigenvectors of a real symmetric matrix
+   *
+   * @param check_symmetric pass false to skip the symmetry check when the
+   *                        caller already guarantees a symmetric matrix
+   */
+  EigsymResult eigsym(bool check_symmetric = true) const;
+  /**
+   * @brief Eigenvalues (ascending) and eigenvectors using the given algorithm
+   *
+   * @throws InvalidMatrixSize if the matrix is not square, or not symmetric
+   *                           when check_symmetric is set
+   * @throws std::runtime_error if the iteration does not converge
+   */
+  EigsymResult eigsym(EigsymMethod method, bool check_symmetric = true) const;
+  /**
+   * @brief Lowest eigenpairs, refined from the decomposition of a nearby matrix
+   *
+   * Meant for sequences of slowly changing matrices, such as the Fock
+   * matrices of late SCF iterations. `guess` holds the lowest p >=
+   * num_eigenpairs eigenpairs of the previous matrix: the full result of
+   * eigsym(), or the result of the previous eigsym_warm() call, so calls can
+   * be chained. The lowest num_eigenpairs eigenpairs are refined by
+   * Rayleigh-Ritz in the old eigenvectors plus corrections preconditioned
+   * with the old eigenvalues that are available (and with the diagonal of
+   * the matrix outside the old eigenvectors), at O(n^2 k) per iteration
+   * instead of O(n^3). Falls back to the full solver when the refinement
+   * stalls, and uses it directly for more than n / 4 eigenpairs, where
+   * refining costs as much as starting over.
+   *
+   * @return num_eigenpairs ascending eigenvalues and an n x num_eigenpairs
+   *         column-major eigenvector matrix
+   * @throws InvalidMatrixSize if the matrix is not square or not symmetric,
+   *         the guess holds fewer than num_eigenpairs eigenpairs, or
+   *         num_eigenpairs is not in [1, n]
+   */
+  EigsymResult eigsym_warm(const EigsymResult& guess, index_t num_eigenpairs,
+                           bool check_symmetric = true) const;
+
+  // === Functions of Symmetric Matrices ===
+  /**
+   * @brief f(A) = V diag(f(w)) V^T from one eigendecomposition A = V diag(w) V^T
+   *
+   * The columns of V are scaled by sqrt|f(w)|, and the result is formed as
+   * one symmetric rank-k update (only one triangle is computed, then
+   * mirrored), half the work of the two general products
+   * V * diag(f(w)) * V^T. Eigenvalues with f(w) = 0 cost nothing.
+   *
+   * @throws InvalidMatrixSize if the matrix is not square, or not symmetric
+   *                           when check_symmetric is set
+   */
+  Matrix funm_sym(const std::function<double(double)>& f, bool check_symmetric = true) const;
+  /**
+   * @brief Square root of a positive semidefinite matrix
+   *
+   * Eigenvalues at or below threshold are treated as zero.
+   *
+   * @throws std::domain_error if an eigenvalue is negative beyond rounding
+   *                           and below -threshold
+   */
+  Matrix sqrtm_sym(double threshold = 0.0) const;
+  /**
+   * @brief Inverse square root, e.g. S^-1/2 for Lowdin orthogonalization
+   *
+   * Eigenvalues at or below threshold are projected out, giving the
+   * pseudo-inverse square root; with a threshold such as 1e-8 a nearly
+   * linearly dependent overlap matrix stays well conditioned.
+   *
+   * @throws std::domain_error if an eigenvalue is negative beyond rounding
+   *                           and below -threshold
+   */
+  Matrix invsqrtm_sym(double threshold = 0.0) const;
+  /**
+   * @brief Matrix exponential of a symmetric matrix
+   */
+  Matrix expm_sym() const;
+  /**
+   * @brief Principal logarithm of a positive definite matrix
+   * @throws std::domain_error if an eigenvalue is not positive
+   */
+  Matrix logm_sym() const;
 
   // === Saving to HDF5 File ===
   static void save_hdf5(const Matrix& data, const std::string& filename, const std::string& dataset_name);
   static void save_hdf5(const vec& data, const std::string& filename, const std::string& dataset_name);
 
+  // === Text Input/Output ===
+  /**
+   * @brief Write matrix as delimited text, one matrix row per line
+   *
+   * Values are formatted with std::to_chars into a large buffer which is
+   * written to the stream in blocks.
+   *
+   * @param precision significant digits per value; a negative value writes
+   *                  the shortest representation that reads back exactly
+   */
+  static void write_text(std::ostream& out, const Matrix& data,
+                         TextFormat format = TextFormat::Whitespace, int precision = -1);
+  /**
+   * @brief Write vector as a column, one value per line
+   *
+   * With a single value per line there is no delimiter, so every format
+   * gives the same output; the format is accepted only to mirror the
+   * Matrix overload.
+   */
+  static void write_text(std::ostream& out, const vec& data,
+                         TextFormat format = TextFormat::Whitespace, int precision = -1);
+  static void save_text(const Matrix& data, const std::string& filename,
+                        TextFormat format = TextFormat::Whitespace, int precision = -1);
+  static void save_text(const vec& data, const std::string& filename,
+                        TextFormat format = TextFormat::Whitespace, int precision = -1);
+
+  /**
+   * @brief Parse a delimited text matrix written by write_text (or similar)
+   *
+   * Every non-empty line is one row and all rows must have the same number
+   * of columns.
+   *
+   * @throws InvalidMatrixSize if the rows have different lengths
+   * @throws std::runtime_error if a value cannot be parsed or the file cannot be opened
+   */
+  static Matrix read_text(std::istream& in, TextFormat format = TextFormat::Whitespace);
+  static Matrix load_text(const std::string& filename, TextFormat format = TextFormat::Whitespace);
+
+};
+
+/**
+ * @class DiagonalMatrix
+ * @brief Square diagonal matrix stored as its n diagonal entries
+ *
+ * Products with dense matrices are row or column scalings, O(n^2) instead
+ * of a dense O(n^3) multiplication, and congruence(V, D) forms V * D * V^T
+ * computing only one triangle of the symmetric result. Converts implicitly
+ * to a dense Matrix so existing code taking a Matrix keeps working.
+ */
+class DiagonalMatrix {
+private:
+  vec values;
+
+public:
+  // === Constructors ===
+  DiagonalMatrix() = default;
+  explicit DiagonalMatrix(const vec& diagonal);
+  explicit DiagonalMatrix(vec&& diagonal);
+
+  // === Accessors ===
+  index_t get_num_rows() const;
+  index_t get_num_cols() const;
+  const vec& get_diagonal() const;
+
+  /**
+   * @brief Element (x, y), zero off the diagonal
+   * @throws std::out_of_range if the indices are invalid
+   */
+  double operator()(index_t x, index_t y) const;
+
+  // === Conversion ===
+  Matrix to_dense() const;
+  operator Matrix() const;
+
+  // === Operators ===
+  DiagonalMatrix operator*(const DiagonalMatrix& other) const;
+  DiagonalMatrix operator*(double s) const;
+  vec operator*(const vec& x) const;
+};
+
+// === Diagonal Matrix Products ===
+/**
+ * @brief D * A, scales row i of A by D(i, i)
+ * @throws InvalidMatrixSize if the dimensions are incompatible
+ */
+Matrix operator*(const DiagonalMatrix& D, const Matrix& A);
+
+/**
+ * @brief A * D, scales column j of A by D(j, j)
+ * @throws InvalidMatrixSize if the dimensions are incompatible
+ */
+Matrix operator*(const Matrix& A, const DiagonalMatrix& D);
+
+Matrix operator+(const Matrix& A, const DiagonalMatrix& D);
+Matrix operator+(const DiagonalMatrix& D, const Matrix& A);
+Matrix operator-(const Matrix& A, const DiagonalMatrix& D);
+Matrix operator-(const DiagonalMatrix& D, const Matrix& A);
+
+/**
+ * @brief V * D * V^T for V (n x k) and diagonal D (k x k)
+ *
+ * Scales the columns of V by sqrt|d_j| and forms only the upper triangle
+ * of the product, mirroring it into the lower one (dsyrk on the Blas
+ * backend): n^2 k multiply-adds instead of the 2 n^2 k (plus a full n x n
+ * temporary) of two dense products. Columns with d_j = 0 are skipped.
+ *
+ * @throws InvalidMatrixSize if the dimensions are incompatible
+ */
+Matrix congruence(const Matrix& V, const DiagonalMatrix& D);
+
+/**
+ * @class TransposeView
+ * @brief Read-only transpose of a Matrix, returned by Matrix::t()
+ *
+ * Holds a reference to the original matrix. A.t() * B, A * B.t(), A + B.t()
+ * and A - B.t() go straight to kernels that read the untransposed operand,
+ * so no transposed temporary is built. Anything else converts the view to
+ * a Matrix.
+ */
+class TransposeView {
+private:
+  const Matrix& m;
+
+public:
+  explicit TransposeView(const Matrix& parent);
+
+  // === Accessors ===
+  index_t get_num_rows() const;
+  index_t get_num_cols() const;
+  index_t get_size() const;
+  /**
+   * @brief The matrix being transposed
+   */
+  const Matrix& parent() const;
+
+  /**
+   * @brief Element (x, y) of the transpose, i.e. parent()(y, x)
+   * @throws std::out_of_range if the indices are invalid
+   */
+  const double& operator()(index_t x, index_t y) const;
+
+  // === Conversion ===
+  /**
+   * @brief Materialize the transpose, copying tile by tile
+   */
+  Matrix eval() const;
+  operator Matrix() const;
+
+  /**
+   * @brief Transpose of the transpose, the original matrix
+   */
+  const Matrix& t() const;
 };
 
+// === Transposed Products and Sums ===
+/**
+ * @brief A^T * B with A (k x m) and B (k x n), without forming A^T
+ * @throws InvalidMatrixSize if the dimensions are incompatible
+ */
+Matrix operator*(const TransposeView& At, const Matrix& B);
+
+/**
+ * @brief A * B^T with A (m x k) and B (n x k), rows of A dotted with rows of B
+ * @throws InvalidMatrixSize if the dimensions are incompatible
+ */
+Matrix operator*(const Matrix& A, const TransposeView& Bt);
+
+/**
+ * @brief A^T * B^T, computed as the transpose of B * A
+ * @throws InvalidMatrixSize if the dimensions are incompatible
+ */
+Matrix operator*(const TransposeView& At, const TransposeView& Bt);
+
+/**
+ * @brief A^T * x, the same as x^T * A
+ */
+vec operator*(const TransposeView& At, const vec& x);
+
+/**
+ * @brief x^T * A^T, the same as A * x
+ */
+vec operator*(const vec& x, const TransposeView& At);
+
+/**
+ * @brief Elementwise sums and differences with a transposed operand,
+ *        e.g. B + B.t() to symmetrize
+ * @throws InvalidMatrixSize if the shapes differ
+ */
+Matrix operator+(const Matrix& A, const TransposeView& Bt);
+Matrix operator+(const TransposeView& At, const Matrix& B);
+Matrix operator-(const Matrix& A, const TransposeView& Bt);
+Matrix operator-(const TransposeView& At, const Matrix& B);
+Matrix operator+(const TransposeView& At, const TransposeView& Bt);
+Matrix operator-(const TransposeView& At, const TransposeView& Bt);
+
 /**
  * @brief Result of Householder Tridiagonalization
  * 
@@ -149,7 +728,7 @@ struct TridiagonalResult {
  */
 struct QLEigenResult {
     vec eigenvalues;
-    Matrix Q_ql;
+    Matrix Q_ql; // column-major
 };
 
 /**
@@ -159,8 +738,134 @@ struct QLEigenResult {
  */
 struct EigsymResult {
     vec eigenvalues;
-    Matrix eigenvectors;
+    Matrix eigenvectors; // one eigenvector per column, stored column-major
 };
 
+// === Elementwise Kernels and Reductions on Two Matrices ===
+/**
+ * @brief Combine two same-shaped matrices elementwise, C(i,j) = f(A(i,j), B(i,j))
+ *
+ * The result is stored in A's layout; B is converted first if it differs.
+ *
+ * @throws InvalidMatrixSize if the shapes differ
+ */
+template <typename F>
+Matrix zip(const Matrix& A, const Matrix& B, F f);
+
+/**
+ * @brief Fold two same-shaped matrices elementwise, f(acc, A(i,j), B(i,j))
+ *
+ * Same chunking and determinism rules as Matrix::reduce.
+ */
+template <typename T, typename F, typename CombineF>
+T zip_reduce(const Matrix& A, const Matrix& B, T init, F f, CombineF combine);
+
+/**
+ * @brief Vector-matrix product y^T = x^T * A
+ *
+ * Rows of A are accumulated with contiguous axpy updates instead of
+ * reading A column by column.
+ *
+ * @throws InvalidMatrixSize if x.size() != number of rows of A
+ */
+vec operator*(const vec& x, const Matrix& A);
+
+/**
+ * @brief True if A and B have the same shape and, for every element,
+ *        |a - b| <= atol + rtol * max(|a|, |b|)
+ *
+ * NaN never compares equal. Stops at the first block containing a mismatch.
+ */
+bool approx_equal(const Matrix& A, const Matrix& B, double atol = 1e-10, double rtol = 1e-10);
+
+/**
+ * @brief Frobenius inner product, sum of A(i,j) * B(i,j)
+ */
+double dot(const Matrix& A, const Matrix& B);
+
+/**
+ * @brief trace(A * B) computed without forming the product
+ *
+ * @throws InvalidMatrixSize unless A is m x n and B is n x m
+ */
+double trace_prod(const Matrix& A, const Matrix& B);
+
+/**
+ * @brief Root mean square of A - B, e.g. the density change between SCF iterations
+ */
+double rms_diff(const Matrix& A, const Matrix& B);
+
 // === Printing Functionality ===
-std::ostream& operator<<(std::ostream& out, const Matrix & M);
\ No newline at end of file
+std::ostream& operator<<(std::ostream& out, const Matrix & M);
+
+// === Template Definitions ===
+
+template <typename F>
+Matrix Matrix::map(F f) const {
+  Matrix result(num_rows, num_cols, uninitialized, layout);
+  const double* m = mem;
+  double* r = result.mem;
+
+  parallel_for(0, size, elementwise_grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+      r[i] = f(m[i]);
+    }
+  });
+  return result;
+}
+
+template <typename T, typename F, typename CombineF>
+T Matrix::reduce(T init, F f, CombineF combine) const {
+  const double* m = mem;
+
+  return parallel_reduce(0, size, elementwise_grain, init,
+    [&](std::size_t begin, std::size_t end) {
+      T acc = init;
+      for (std::size_t i = begin; i < end; i++) {
+        acc = f(acc, m[i]);
+      }
+      return acc;
+    }, combine);
+}
+
+template <typename F>
+Matrix zip(const Matrix& A, const Matrix& B, F f) {
+  if (A.get_num_rows() != B.get_num_rows() || A.get_num_cols() != B.get_num_cols()) {
+    throw InvalidMatrixSize("Matrix sizes must match for elementwise operations");
+  }
+  if (B.get_layout() != A.get_layout()) {
+    return zip(A, B.to_layout(A.get_layout()), f);
+  }
+  Matrix result(A.get_num_rows(), A.get_num_cols(), Matrix::uninitialized, A.get_layout());
+  const double* a = A.memptr();
+  const double* b = B.memptr();
+  double* r = result.memptr();
+
+  parallel_for(0, A.get_size(), elementwise_grain, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+      r[i] = f(a[i], b[i]);
+    }
+  });
+  return result;
+}
+
+template <typename T, typename F, typename CombineF>
+T zip_reduce(const Matrix& A, const Matrix& B, T init, F f, CombineF combine) {
+  if (A.get_num_rows() != B.get_num_rows() || A.get_num_cols() != B.get_num_cols()) {
+    throw InvalidMatrixSize("Matrix sizes must match for elementwise operations");
+  }
+  if (B.get_layout() != A.get_layout()) {
+    return zip_reduce(A, B.to_layout(A.get_layout()), init, f, combine);
+  }
+  const double* a = A.memptr();
+  const double* b = B.memptr();
+
+  return parallel_reduce(0, A.get_size(), elementwise_grain, init,
+    [&](std::size_t begin, std::size_t end) {
+      T acc = init;
+      for (std::size_t i = begin; i < end; i++) {
+        acc = f(acc, a[i], b[i]);
+      }
+      return acc;
+    }, combine);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Number of threads used by the library's parallel kernels
+ *
+ * Defaults to std::thread::hardware_concurrency(), or to the value of the
+ * MATRIXLIBRARY_NUM_THREADS environment variable when it is set.
+ */
+int get_num_threads();
+
+/**
+ * @brief Set the number of threads used by the library's parallel kernels
+ *
+ * A value of 1 runs every kernel on the calling thread. Values below 1 reset
+ * to the default.
+ */
+void set_num_threads(int n);
+
+/**
+ * @brief Number of elements per chunk for elementwise kernels and reductions
+ *
+ * Small enough to load balance, large enough that a chunk is far more work
+ * than handing it to a worker thread.
+ */
+constexpr std::size_t elementwise_grain = 1 << 15;
+
+/**
+ * @brief Run body(chunk_begin, chunk_end) over [begin, end) split into chunks
+ *
+ * The range is split into consecutive chunks of `grain` indices which are
+ * handed out to the library's worker threads; the calling thread works on
+ * chunks too and returns once all of them are done. Chunk boundaries only
+ * depend on `grain`, never on the thread count, so results combined per chunk
+ * are identical however many threads run.
+ *
+ * Runs inline when there is a single chunk, a single thread, or when called
+ * from inside another parallel_for. The first exception thrown by body is
+ * rethrown on the calling thread.
+ */
+void parallel_for_chunks(std::size_t begin, std::size_t end, std::size_t grain,
+                         const std::function<void(std::size_t, std::size_t)>& body);
+
+/**
+ * @brief Same as parallel_for_chunks, but small ranges skip the std::function
+ */
+template <typename F>
+void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, F&& body) {
+  if (end <= begin) {
+    return;
+  }
+  if (end - begin <= grain) {
+    body(begin, end);
+    return;
+  }
+  parallel_for_chunks(begin, end, grain, std::function<void(std::size_t, std::size_t)>(std::ref(body)));
+}
+
+/**
+ * @brief Deterministic parallel reduction over [begin, end)
+ *
+ * chunk(chunk_begin, chunk_end) reduces one chunk and combine(a, b) merges
+ * two partial results. Partial results are combined in chunk order, so the
+ * result does not depend on the thread count. init must be the identity of
+ * combine.
+ */
+template <typename T, typename ChunkF, typename CombineF>
+T parallel_reduce(std::size_t begin, std::size_t end, std::size_t grain,
+                  T init, ChunkF chunk, CombineF combine) {
+  if (end <= begin) {
+    return init;
+  }
+  if (grain == 0) grain = 1;
+  if (end - begin <= grain) {
+    return combine(init, chunk(begin, end));
+  }
+  std::size_t num_chunks = (end - begin + grain - 1) / grain;
+  std::vector<T> partial(num_chunks, init);
+
+  parallel_for(begin, end, grain, [&](std::size_t b, std::size_t e) {
+    partial[(b - begin) / grain] = chunk(b, e);
+  });
+
+  T result = init;
+  for (const T& p : partial) {
+    result = combine(result, p);
+  }
+  return result;
+}
@@ -2,14 +2,26 @@
 #include <iostream>
 #include <vector>
 #include <iomanip>
+#include <charconv>
+#include <string>
 
 /**
  * @brief Overload print operator for vector
+ *
+ * Values are formatted with std::to_chars into one buffer and written
+ * with a single stream call.
  */
 inline std::ostream& operator<<(std::ostream& out, const std::vector<double>& v) {
   out << std::fixed << std::setprecision(4);
+
+  std::string buffer;
+  buffer.reserve(v.size() * 10);
+  char number[400]; // fits any double in fixed notation
   for (double x : v) {
-    out << x << "\n";
+    auto res = std::to_chars(number, number + sizeof(number), x, std::chars_format::fixed, 4);
+    buffer.append(number, res.ptr);
+    buffer.push_back('\n');
   }
+  out.write(buffer.data(), buffer.size());
   return out;
-}
\ No newline at end of file
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "matrix.h"
+#include "sparse_matrix.hpp"
+
+// Density matrices without diagonalization. Purification maps the Fock
+// matrix to the projector onto its occupied eigenvectors using nothing but
+// matrix products, so it runs on the parallel GEMM (or the sparse products
+// for matrices with decay) instead of the sequential QL iteration, and
+// costs O(n) per product for sparse input.
+
+/**
+ * @brief Settings for purify_density()
+ */
+struct PurificationOptions {
+  double tol = 1e-10;        // converged once ||P^2 - P||_F <= tol, or once the
+                             // error, below 1e-4, is no smaller than two steps
+                             // before (rounding floor)
+  int max_iterations = 100;
+  double drop_tol = 0.0;     // sparse input only: products drop |p_ij| <= drop_tol
+};
+
+/**
+ * @brief Density matrix found by purify_density()
+ */
+template <typename MatrixType>
+struct PurificationResult {
+  MatrixType density;              // projector P with trace(P) = num_occupied
+  int iterations = 0;              // number of purification steps
+  double idempotency_error = 0.0;  // ||P^2 - P||_F
+};
+
+/**
+ * @brief Density matrix of an orthogonalized Fock matrix by trace-correcting
+ *        purification (TC2)
+ *
+ * Following Niklasson, Phys. Rev. B 66, 155115 (2002): F is mapped to
+ * X0 = (e_max I - F) / (e_max - e_min) with Gershgorin bounds, whose
+ * spectrum lies in [0, 1], then each step applies X^2 or 2X - X^2, whichever
+ * moves trace(X) towards num_occupied. Both maps push the occupied
+ * eigenvalues to 1 and the virtual ones to 0, and the number of steps grows
+ * with log(spread / gap), not with n. One product per step.
+ *
+ * The result is the projector onto the num_occupied lowest eigenvectors;
+ * for a closed-shell system num_occupied is half the electron count and the
+ * density matrix is 2P.
+ *
+ * @param F             symmetric Fock matrix in an orthonormal basis
+ * @param num_occupied  number of occupied orbitals, 0 <= num_occupied <= n
+ * @throws InvalidMatrixSize if F is not square or not symmetric, or
+ *         num_occupied is out of range
+ * @throws std::runtime_error if the iteration does not converge, or the
+ *         trace misses num_occupied because there is no gap at the Fermi level
+ */
+PurificationResult<Matrix> purify_density(const Matrix& F, index_t num_occupied,
+                                          const PurificationOptions& options = {});
+
+/**
+ * @brief TC2 purification with sparse products, dropping entries at or
+ *        below options.drop_tol after every step
+ *
+ * For Fock matrices with a gap the density matrix decays exponentially, so
+ * with a drop tolerance every iterate stays sparse and a step costs O(n).
+ * Truncation perturbs idempotency by about drop_tol * sqrt(nnz).
+ */
+PurificationResult<SparseMatrix> purify_density(const SparseMatrix& F, index_t num_occupied,
+                                                const PurificationOptions& options = {});
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "matrix.h"
+
+// Compressed sparse row storage for matrices that are numerically sparse,
+// such as density and Fock matrices of large systems with a gap, whose
+// elements decay with distance. Entries below a drop tolerance are not
+// stored, so memory and product cost scale with the number of significant
+// elements rather than n^2.
+
+/**
+ * @class SparseMatrix
+ * @brief Real matrix in compressed sparse row (CSR) format
+ *
+ * Row i stores its entries in values[row_ptr[i] .. row_ptr[i + 1]), with
+ * column indices in col_idx at the same positions, ascending and without
+ * duplicates. An entry may be stored and still be zero, e.g. after
+ * cancellation in a sum; prune() removes such entries.
+ *
+ * Products and sums are built row by row in parallel; chunking depends only
+ * on the operands, so results do not depend on the thread count.
+ */
+class SparseMatrix {
+private:
+  index_t num_rows = 0;
+  index_t num_cols = 0;
+  std::vector<index_t> row_ptr{0};
+  std::vector<index_t> col_idx;
+  vec values;
+
+  // computes rows [begin, end) in parallel chunks, see sparse_matrix.cpp
+  template <typename ChunkF>
+  static SparseMatrix build_rows(index_t rows, index_t cols, std::size_t chunk_rows, ChunkF fill);
+
+  // this + beta * other over the union of both patterns
+  SparseMatrix add_scaled(const SparseMatrix& other, double beta) const;
+
+public:
+  // === Constructors ===
+  SparseMatrix() = default;
+
+  /**
+   * @brief rows x cols matrix with no stored entries
+   */
+  SparseMatrix(index_t rows, index_t cols);
+
+  /**
+   * @brief Matrix from CSR arrays, which are validated and taken over
+   * @throws InvalidMatrixSize if the array lengths do not fit the shape
+   * @throws std::out_of_range if a column index is outside the matrix
+   * @throws std::invalid_argument if row_ptr decreases or the columns of a
+   *         row are not strictly ascending
+   */
+  SparseMatrix(index_t rows, index_t cols, std::vector<index_t> row_ptr,
+               std::vector<index_t> col_idx, vec values);
+
+  /**
+   * @brief Sparse copy of A keeping the entries with |a_ij| > drop_tol
+   *
+   * A drop tolerance of 0 keeps every nonzero entry.
+   */
+  static SparseMatrix from_dense(const Matrix& A, double drop_tol = 0.0);
+
+  static SparseMatrix Identity(index_t n);
+
+  // === Accessors ===
+  index_t get_num_rows() const;
+  index_t get_num_cols() const;
+  index_t nnz() const; // number of stored entries
+  double density() const; // nnz / (rows * cols)
+  const std::vector<index_t>& get_row_ptr() const;
+  const std::vector<index_t>& get_col_idx() const;
+  const vec& get_values() const;
+
+  /**
+   * @brief Element (i, j), zero if not stored; a binary search in row i
+   * @throws std::out_of_range if the indices are invalid
+   */
+  double operator()(index_t i, index_t j) const;
+
+  vec diagonal() const;
+
+  // === Conversion ===
+  Matrix to_dense(Layout layout = Layout::RowMajor) const;
+
+  /**
+   * @brief Copy without the entries with |a_ij| <= drop_tol
+   */
+  SparseMatrix prune(double drop_tol = 0.0) const;
+
+  SparseMatrix transpose() const;
+
+  // === Properties ===
+  double norm_fro() const;
+
+  /**
+   * @brief True if |A(i,j) - A(j,i)| <= tol for all i, j, stored or not
+   */
+  bool is_symmetric(double tol = 1e-12) const;
+
+  // === Operators ===
+  /**
+   * @brief Sum over the union of both sparsity patterns
+   * @throws InvalidMatrixSize if the shapes differ
+   */
+  SparseMatrix operator+(const SparseMatrix& other) const;
+  SparseMatrix operator-(const SparseMatrix& other) const;
+  SparseMatrix operator*(double s) const;
+
+  /**
+   * @brief Sparse product, same as multiply(other, 0.0)
+   */
+  SparseMatrix operator*(const SparseMatrix& other) const;
+
+  /**
+   * @brief Sparse product that drops entries with |c_ij| <= drop_tol
+   *
+   * Row-wise Gustavson product: row i of the result accumulates
+   * a_ik * B(k, :) over the stored a_ik in a dense scratch row, and only the
+   * entries above the tolerance are kept, so the truncated product never
+   * holds the full fill-in. Rows are computed in parallel.
+   *
+   * @throws InvalidMatrixSize if the dimensions are incompatible
+   */
+  SparseMatrix multiply(const SparseMatrix& other, double drop_tol) const;
+
+  /**
+   * @brief Sparse times dense, in the layout of X, rows in parallel
+   * @throws InvalidMatrixSize if the dimensions are incompatible
+   */
+  Matrix operator*(const Matrix& X) const;
+
+  /**
+   * @brief Sparse matrix-vector product
+   * @throws InvalidMatrixSize if the dimensions are incompatible
+   */
+  vec operator*(const vec& x) const;
+};
+
+SparseMatrix operator*(double s, const SparseMatrix& A);
@@ -0,0 +1,205 @@
+#include "blas_backend.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#ifdef MATRIXLIBRARY_USE_BLAS
+// Fortran BLAS/LAPACK entry points (LP64 integers)
+extern "C" {
+void dgemm_(const char* transa, const char* transb, const int* m, const int* n,
+            const int* k, const double* alpha, const double* a, const int* lda,
+            const double* b, const int* ldb, const double* beta, double* c,
+            const int* ldc);
+void dsyrk_(const char* uplo, const char* trans, const int* n, const int* k,
+            const double* alpha, const double* a, const int* lda, const double* beta,
+            double* c, const int* ldc);
+void dtrsm_(const char* side, const char* uplo, const char* transa, const char* diag,
+            const int* m, const int* n, const double* alpha, const double* a,
+            const int* lda, double* b, const int* ldb);
+void dsyevd_(const char* jobz, const char* uplo, const int* n, double* a,
+             const int* lda, double* w, double* work, const int* lwork,
+             int* iwork, const int* liwork, int* info);
+}
+#endif
+
+namespace {
+
+Backend default_backend() {
+  if (const char* env = std::getenv("MATRIXLIBRARY_BACKEND")) {
+    if (std::strcmp(env, "native") == 0) return Backend::Native;
+  }
+  return backend_available(Backend::Blas) ? Backend::Blas : Backend::Native;
+}
+
+std::atomic<Backend>& current_backend() {
+  static std::atomic<Backend> backend{default_backend()};
+  return backend;
+}
+
+#ifdef MATRIXLIBRARY_USE_BLAS
+// dimensions above INT_MAX cannot be passed to an LP64 BLAS
+bool fits_blas_int(index_t x) {
+  return x <= std::numeric_limits<int>::max();
+}
+#endif
+
+} // namespace
+
+bool backend_available(Backend backend) {
+#ifdef MATRIXLIBRARY_USE_BLAS
+  return backend == Backend::Native || backend == Backend::Blas;
+#else
+  return backend == Backend::Native;
+#endif
+}
+
+Backend get_backend() {
+  return current_backend().load();
+}
+
+void set_backend(Backend backend) {
+  if (!backend_available(backend)) {
+    throw std::runtime_error("Requested backend is not available in this build");
+  }
+  current_backend() = backend;
+}
+
+bool blas_gemm(bool trans_a, bool trans_b, index_t m, index_t n, index_t k,
+               const double* A, const double* B, double* C) {
+#ifdef MATRIXLIBRARY_USE_BLAS
+  if (get_backend() != Backend::Blas || m == 0 || n == 0 || !fits_blas_int(m) ||
+      !fits_blas_int(n) || !fits_blas_int(k)) {
+    return false;
+  }
+  if (k == 0) {
+    std::fill(C, C + m * n, 0.0);
+    return true;
+  }
+  // column-major view: C^T (n x m) = op(B)^T (n x k) * op(A)^T (k x m)
+  const char tb = trans_b ? 'T' : 'N';
+  const char ta = trans_a ? 'T' : 'N';
+  const int mi = static_cast<int>(m), ni = static_cast<int>(n), ki = static_cast<int>(k);
+  const int ldb = trans_b ? ki : ni;
+  const int lda = trans_a ? mi : ki;
+  const double one = 1.0, zero = 0.0;
+  dgemm_(&tb, &ta, &ni, &mi, &ki, &one, B, &ldb, A, &lda, &zero, C, &ni);
+  return true;
+#else
+  (void)trans_a; (void)trans_b; (void)m; (void)n; (void)k; (void)A; (void)B; (void)C;
+  return false;
+#endif
+}
+
+bool blas_gemm_update(index_t m, index_t n, index_t k, const double* A, index_t lda,
+                      const double* B, index_t ldb, double* C, index_t ldc) {
+#ifdef MATRIXLIBRARY_USE_BLAS
+  if (get_backend() != Backend::Blas || !fits_blas_int(m) || !fits_blas_int(n) ||
+      !fits_blas_int(k) || !fits_blas_int(lda) || !fits_blas_int(ldb) || !fits_blas_int(ldc)) {
+    return false;
+  }
+  if (m == 0 || n == 0 || k == 0) {
+    return true;
+  }
+  // column-major view: C^T (n x m) -= B^T (n x k) * A^T (k x m)
+  const char no = 'N';
+  const int mi = static_cast<int>(m), ni = static_cast<int>(n), ki = static_cast<int>(k);
+  const int ldai = static_cast<int>(lda), ldbi = static_cast<int>(ldb);
+  const int ldci = static_cast<int>(ldc);
+  const double minus_one = -1.0, one = 1.0;
+  dgemm_(&no, &no, &ni, &mi, &ki, &minus_one, B, &ldbi, A, &ldai, &one, C, &ldci);
+  return true;
+#else
+  (void)m; (void)n; (void)k; (void)A; (void)lda; (void)B; (void)ldb; (void)C; (void)ldc;
+  return false;
+#endif
+}
+
+bool blas_syrk(bool trans, index_t n, index_t k, double alpha, const double* A, index_t lda,
+               double beta, double* C, index_t ldc) {
+#ifdef MATRIXLIBRARY_USE_BLAS
+  if (get_backend() != Backend::Blas || !fits_blas_int(n) || !fits_blas_int(k) ||
+      !fits_blas_int(lda) || !fits_blas_int(ldc)) {
+    return false;
+  }
+  if (n == 0) {
+    return true;
+  }
+  // column-major view: a row-major array is the transpose, so op(A) op(A)^T
+  // is A^T^T A^T ('T') or A^T A^T^T ('N'), and the upper triangle of the
+  // row-major C is the lower triangle of its column-major form
+  const char uplo = 'L', t = trans ? 'N' : 'T';
+  const int ni = static_cast<int>(n), ki = static_cast<int>(k);
+  const int ldai = static_cast<int>(std::max<index_t>(lda, 1));
+  const int ldci = static_cast<int>(ldc);
+  dsyrk_(&uplo, &t, &ni, &ki, &alpha, A, &ldai, &beta, C, &ldci);
+  return true;
+#else
+  (void)trans; (void)n; (void)k; (void)alpha; (void)A; (void)lda; (void)beta; (void)C;
+  (void)ldc;
+  return false;
+#endif
+}
+
+bool blas_trsm(bool lower, bool transpose, bool unit_diagonal, index_t n, index_t m,
+               const double* T, index_t ldt, double* B, index_t ldb) {
+#ifdef MATRIXLIBRARY_USE_BLAS
+  if (get_backend() != Backend::Blas || !fits_blas_int(n) || !fits_blas_int(m) ||
+      !fits_blas_int(ldt) || !fits_blas_int(ldb)) {
+    return false;
+  }
+  if (n == 0 || m == 0) {
+    return true;
+  }
+  // column-major view: X^T op(T)^T = B^T with B^T m x n, solved from the
+  // right; T^T swaps the stored triangle
+  const char side = 'R', uplo = lower ? 'U' : 'L', transa = transpose ? 'T' : 'N';
+  const char diag = unit_diagonal ? 'U' : 'N';
+  const int mi = static_cast<int>(m), ni = static_cast<int>(n);
+  const int ldti = static_cast<int>(ldt), ldbi = static_cast<int>(ldb);
+  const double one = 1.0;
+  dtrsm_(&side, &uplo, &transa, &diag, &mi, &ni, &one, T, &ldti, B, &ldbi);
+  return true;
+#else
+  (void)lower; (void)transpose; (void)unit_diagonal; (void)n; (void)m; (void)T; (void)ldt;
+  (void)B; (void)ldb;
+  return false;
+#endif
+}
+
+bool lapack_syevd(index_t n, double* A, double* eigenvalues) {
+#ifdef MATRIXLIBRARY_USE_BLAS
+  // dsyevd needs a workspace of 1 + 6n + 2n^2 doubles, counted in an int
+  if (get_backend() != Backend::Blas || !fits_blas_int(1 + 6 * n + 2 * n * n)) {
+    return false;
+  }
+  if (n == 0) {
+    return true;
+  }
+  // A is symmetric, so the row-major array is already its column-major form
+  const char jobz = 'V', uplo = 'U';
+  const int ni = static_cast<int>(n);
+  int info = 0;
+  int lwork = -1, liwork = -1, iwork_query = 0;
+  double work_query = 0.0;
+  dsyevd_(&jobz, &uplo, &ni, A, &ni, eigenvalues, &work_query, &lwork,
+          &iwork_query, &liwork, &info);
+
+  lwork = static_cast<int>(work_query);
+  liwork = iwork_query;
+  std::vector<double> work(lwork);
+  std::vector<int> iwork(liwork);
+  dsyevd_(&jobz, &uplo, &ni, A, &ni, eigenvalues, work.data(), &lwork,
+          iwork.data(), &liwork, &info);
+  if (info != 0) {
+    throw std::runtime_error("eigsym: LAPACK dsyevd failed to converge");
+  }
+  return true;
+#else
+  (void)n; (void)A; (void)eigenvalues;
+  return false;
+#endif
+}
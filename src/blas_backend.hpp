@@ -0,0 +1,57 @@
+#pragma once
+
+#include "backend.hpp"
+#include "matrix.h"
+
+// Thin wrappers around the BLAS/LAPACK routines used by the Blas backend.
+// They take the library's row-major arrays and return false when the
+// backend is not active, or when a dimension does not fit the 32-bit
+// integers of an LP64 BLAS, so callers fall through to their native kernels.
+
+/**
+ * @brief C = op(A) * op(B) with dgemm for row-major A, B and C (m x n)
+ *
+ * trans_a / trans_b select A^T / B^T; k is the inner dimension. A row-major
+ * array is the column-major transpose, so this computes C^T = op(B)^T op(A)^T
+ * by swapping the operands.
+ */
+bool blas_gemm(bool trans_a, bool trans_b, index_t m, index_t n, index_t k,
+               const double* A, const double* B, double* C);
+
+/**
+ * @brief C -= A * B with dgemm for row-major A (m x k), B (k x n) and C (m x n)
+ *
+ * lda, ldb and ldc are the row strides, so all three may be blocks of larger
+ * arrays, such as the trailing update of a blocked factorization.
+ */
+bool blas_gemm_update(index_t m, index_t n, index_t k, const double* A, index_t lda,
+                      const double* B, index_t ldb, double* C, index_t ldc);
+
+/**
+ * @brief C = alpha * op(A) * op(A)^T + beta * C with dsyrk, C is n x n
+ *
+ * op(A) is A (n x k, row-major) or, with trans, A^T for A (k x n). lda and
+ * ldc are the row strides, so A and C may be blocks of larger arrays. Only
+ * the upper triangle (j >= i) of the row-major C is referenced.
+ */
+bool blas_syrk(bool trans, index_t n, index_t k, double alpha, const double* A, index_t lda,
+               double beta, double* C, index_t ldc);
+
+/**
+ * @brief Solves op(T) * X = B in place with dtrsm, for triangular T (n x n)
+ *        and B (n x m), both row-major with row strides ldt and ldb
+ *
+ * op(T) is T or T^T; `lower` tells which triangle of T is stored, and with
+ * unit_diagonal the diagonal of T is taken as ones without being read.
+ */
+bool blas_trsm(bool lower, bool transpose, bool unit_diagonal, index_t n, index_t m,
+               const double* T, index_t ldt, double* B, index_t ldb);
+
+/**
+ * @brief Eigenvalues (ascending) and eigenvectors of symmetric A with dsyevd
+ *
+ * A (n x n, row-major) is overwritten by the eigenvectors, stored as rows.
+ *
+ * @throws std::runtime_error if dsyevd fails to converge
+ */
+bool lapack_syevd(index_t n, double* A, double* eigenvalues);
@@ -0,0 +1,168 @@
+#include "davidson.hpp"
+#include "eigsym_detail.hpp"
+#include "operand.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+// apply the operator to a block and check what comes back
+Matrix apply_block(const BlockOperator& apply, const Matrix& X) {
+  Matrix AX = apply(X);
+  if (AX.get_num_rows() != X.get_num_rows() || AX.get_num_cols() != X.get_num_cols()) {
+    throw InvalidMatrixSize("davidson: operator returned a block of the wrong shape");
+  }
+  if (AX.get_layout() != Layout::ColMajor) {
+    AX = AX.to_layout(Layout::ColMajor);
+  }
+  return AX;
+}
+
+// unit vectors at the k smallest diagonal entries
+Matrix unit_guess(const vec& diagonal, index_t k) {
+  index_t n = static_cast<index_t>(diagonal.size());
+  std::vector<index_t> idx(n);
+  std::iota(idx.begin(), idx.end(), 0);
+  std::partial_sort(idx.begin(), idx.begin() + k, idx.end(), [&](index_t i, index_t j) {
+    return diagonal[i] < diagonal[j];
+  });
+  Matrix V(n, k, Matrix::zeroed, Layout::ColMajor);
+  for (index_t j = 0; j < k; j++) {
+    V(idx[j], j) = 1.0;
+  }
+  return V;
+}
+
+} // namespace
+
+DavidsonResult davidson(const BlockOperator& apply, const vec& diagonal, index_t k,
+                        const DavidsonOptions& options) {
+  index_t n = static_cast<index_t>(diagonal.size());
+  if (k < 1 || k > n) {
+    throw InvalidMatrixSize("davidson: k must be between 1 and n");
+  }
+  index_t max_subspace = options.max_subspace > 0 ? options.max_subspace : std::max<index_t>(8 * k, 32);
+  max_subspace = std::min(max_subspace, n);
+  if (max_subspace < std::min<index_t>(2 * k, n)) {
+    throw InvalidMatrixSize("davidson: max_subspace must be at least 2k");
+  }
+
+  Matrix V;
+  if (options.guess.get_size() > 0) {
+    if (options.guess.get_num_rows() != n || options.guess.get_num_cols() != k) {
+      throw InvalidMatrixSize("davidson: guess must be n x k");
+    }
+    V = orthonormalize_columns(options.guess.to_layout(Layout::ColMajor));
+    if (V.get_num_cols() < k) {
+      throw InvalidMatrixSize("davidson: guess columns are linearly dependent");
+    }
+  } else {
+    V = unit_guess(diagonal, k);
+  }
+  Matrix AV = apply_block(apply, V);
+
+  for (int iter = 1; iter <= options.max_iterations; iter++) {
+    // Rayleigh-Ritz: the projected problem is small and dense
+    index_t m = V.get_num_cols();
+    Matrix H = multiply(operand(V.t()), operand(AV), m, m, n, Layout::ColMajor);
+    double* h = H.memptr();
+    for (index_t j = 0; j < m; j++) {
+      for (index_t i = j + 1; i < m; i++) {
+        h[i + j * m] = h[j + i * m] = 0.5 * (h[i + j * m] + h[j + i * m]);
+      }
+    }
+    EigsymResult ritz = H.eigsym(false);
+
+    Matrix Y = column_view(ritz.eigenvectors, 0, k);
+    Matrix X = multiply(operand(V), operand(Y), n, k, m, Layout::ColMajor);
+    Matrix AX = multiply(operand(AV), operand(Y), n, k, m, Layout::ColMajor);
+
+    // residuals r_i = A x_i - theta_i x_i, and the preconditioned
+    // corrections t_i = (theta_i - diag(A))^-1 r_i of the unconverged ones
+    DavidsonResult result;
+    result.eigenvalues.assign(ritz.eigenvalues.begin(), ritz.eigenvalues.begin() + k);
+    result.residual_norms.resize(k);
+    result.iterations = iter;
+    std::vector<index_t> unconverged;
+    Matrix T(n, k, Matrix::uninitialized, Layout::ColMajor);
+    for (index_t j = 0; j < k; j++) {
+      double theta = result.eigenvalues[j];
+      const double* x = X.memptr() + j * n;
+      const double* ax = AX.memptr() + j * n;
+      double* t = T.memptr() + unconverged.size() * n;
+      double sq = 0.0;
+      for (index_t i = 0; i < n; i++) {
+        t[i] = ax[i] - theta * x[i];
+        sq += t[i] * t[i];
+      }
+      result.residual_norms[j] = std::sqrt(sq);
+      if (result.residual_norms[j] <= options.tol) {
+        continue;
+      }
+      // a diagonal entry equal to theta would blow up the correction
+      double floor = 1e-8 * std::max(1.0, std::abs(theta));
+      for (index_t i = 0; i < n; i++) {
+        double d = theta - diagonal[i];
+        if (std::abs(d) < floor) {
+          d = d < 0.0 ? -floor : floor;
+        }
+        t[i] /= d;
+      }
+      unconverged.push_back(j);
+    }
+    if (unconverged.empty()) {
+      result.eigenvectors = std::move(X);
+      return result;
+    }
+    index_t u = static_cast<index_t>(unconverged.size());
+    T = Matrix(vec(T.memptr(), T.memptr() + u * n), n, u, Layout::ColMajor);
+
+    // restart: collapse the basis onto the lowest Ritz vectors
+    if (m + u > max_subspace) {
+      index_t keep = std::min(m, std::max(k, max_subspace - u));
+      Matrix Yk = column_view(ritz.eigenvectors, 0, keep);
+      V = multiply(operand(V), operand(Yk), n, keep, m, Layout::ColMajor);
+      AV = multiply(operand(AV), operand(Yk), n, keep, m, Layout::ColMajor);
+    }
+
+    T = orthonormal_complement(V, std::move(T));
+    if (T.get_num_cols() == 0) {
+      throw std::runtime_error("davidson: no new search directions; tol may be below rounding level");
+    }
+    Matrix AT = apply_block(apply, T);
+    V = concat_columns(V, T);
+    AV = concat_columns(AV, AT);
+  }
+  throw std::runtime_error("davidson: no convergence within max_iterations");
+}
+
+DavidsonResult davidson(const Matrix& A, index_t k, const DavidsonOptions& options) {
+  index_t n = A.get_num_rows();
+  if (n != A.get_num_cols()) {
+    throw InvalidMatrixSize("davidson requires a square matrix");
+  }
+  if (!A.is_symmetric(1e-8)) {
+    throw InvalidMatrixSize("Matrix must be symmetric for davidson()");
+  }
+  vec diagonal(n);
+  for (index_t i = 0; i < n; i++) {
+    diagonal[i] = A(i, i);
+  }
+  BlockOperator apply = [&](const Matrix& X) {
+    return multiply(operand(A), operand(X), n, X.get_num_cols(), n, Layout::ColMajor);
+  };
+  return davidson(apply, diagonal, k, options);
+}
+
+DavidsonResult davidson(const SparseMatrix& A, index_t k, const DavidsonOptions& options) {
+  if (A.get_num_rows() != A.get_num_cols()) {
+    throw InvalidMatrixSize("davidson requires a square matrix");
+  }
+  if (!A.is_symmetric(1e-8)) {
+    throw InvalidMatrixSize("Matrix must be symmetric for davidson()");
+  }
+  BlockOperator apply = [&](const Matrix& X) { return A * X; };
+  return davidson(apply, A.diagonal(), k, options);
+}
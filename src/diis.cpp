@@ -0,0 +1,144 @@
+#include "diis.hpp"
+#include "factorizations.hpp"
+#include "kernels.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+bool same_shape(const Matrix& A, const Matrix& B) {
+  return A.get_num_rows() == B.get_num_rows() && A.get_num_cols() == B.get_num_cols();
+}
+
+} // namespace
+
+DIIS::DIIS(index_t max_vectors)
+    : capacity(max_vectors) {
+  if (max_vectors < 1) {
+    throw std::invalid_argument("DIIS: max_vectors must be at least 1");
+  }
+  focks.resize(capacity);
+  errors.resize(capacity);
+  B = Matrix(capacity, capacity, Matrix::zeroed);
+}
+
+index_t DIIS::slot(index_t i) const {
+  return (next - count + i + capacity) % capacity;
+}
+
+void DIIS::extrapolate(Matrix& F, const Matrix& error) {
+  if (!same_shape(F, error)) {
+    throw InvalidMatrixSize("DIIS: Fock and error matrices must have the same shape");
+  }
+  if (count > 0 && !same_shape(error, errors[slot(0)])) {
+    throw InvalidMatrixSize("DIIS: matrices must keep the shape of the stored ones");
+  }
+
+  // copy assignment reuses the slot's buffer once it has been allocated
+  index_t s = next;
+  focks[s] = F;
+  errors[s] = error;
+  next = (next + 1) % capacity;
+  count = std::min(count + 1, capacity);
+
+  // only the row and column of the new error are computed
+  for (index_t i = 0; i < count; i++) {
+    index_t t = slot(i);
+    B(s, t) = B(t, s) = dot(errors[s], errors[t]);
+  }
+
+  // scaled by the largest <e_i, e_i> so the system stays well scaled as the
+  // errors shrink; drop the oldest vectors while it is singular
+  while (true) {
+    index_t m = count;
+    double scale = 0.0;
+    for (index_t i = 0; i < m; i++) {
+      scale = std::max(scale, B(slot(i), slot(i)));
+    }
+    if (!(scale > 0.0)) {
+      // every stored error is zero, F is converged already
+      coeffs.assign(m, 0.0);
+      coeffs.back() = 1.0;
+      break;
+    }
+
+    Matrix A(m + 1, m + 1, Matrix::zeroed);
+    vec rhs(m + 1, 0.0);
+    rhs[m] = -1.0;
+    for (index_t i = 0; i < m; i++) {
+      for (index_t j = 0; j < m; j++) {
+        A(i, j) = B(slot(i), slot(j)) / scale;
+      }
+      A(i, m) = A(m, i) = -1.0;
+    }
+    LUFactor lu(A);
+    if (lu.det() != 0.0) {
+      vec x = lu.solve(rhs);
+      if (std::all_of(x.begin(), x.end(), [](double v) { return std::isfinite(v); })) {
+        coeffs.assign(x.begin(), x.begin() + m);
+        break;
+      }
+    }
+    count--;
+  }
+
+  // F = sum_i c_i F_i, over F's own buffer; slots stored in another layout
+  // (F switched layouts between calls) are converted first
+  Layout layout = F.get_layout();
+  std::vector<Matrix> converted;
+  converted.reserve(count);
+  std::vector<const double*> sources(count);
+  for (index_t i = 0; i < count; i++) {
+    const Matrix& Fi = focks[slot(i)];
+    if (Fi.get_layout() == layout) {
+      sources[i] = Fi.memptr();
+    } else {
+      converted.push_back(Fi.to_layout(layout));
+      sources[i] = converted.back().memptr();
+    }
+  }
+  double* f = F.memptr();
+  parallel_for(0, F.get_size(), elementwise_grain, [&](std::size_t first, std::size_t last) {
+    std::size_t len = last - first;
+    const double* s0 = sources[0] + first;
+    for (std::size_t r = 0; r < len; r++) {
+      f[first + r] = coeffs[0] * s0[r];
+    }
+    for (index_t i = 1; i < count; i++) {
+      axpy_kernel(coeffs[i], sources[i] + first, f + first, len);
+    }
+  });
+}
+
+index_t DIIS::size() const {
+  return count;
+}
+
+index_t DIIS::max_vectors() const {
+  return capacity;
+}
+
+const vec& DIIS::coefficients() const {
+  return coeffs;
+}
+
+double DIIS::error_norm() const {
+  if (count == 0) {
+    return 0.0;
+  }
+  index_t newest = slot(count - 1);
+  return std::sqrt(B(newest, newest));
+}
+
+void DIIS::reset() {
+  count = 0;
+  next = 0;
+  coeffs.clear();
+}
+
+Matrix DIIS::commutator(const Matrix& F, const Matrix& D, const Matrix& S) {
+  Matrix X = F * D * S;
+  return X - X.t();
+}
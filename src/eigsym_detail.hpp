@@ -0,0 +1,54 @@
+#pragma once
+
+#include "matrix.h"
+
+// Pieces shared by the symmetric eigensolvers in matrix_eigendecomp.cpp and
+// matrix_jacobi.cpp.
+
+/**
+ * @brief Eigenpairs reordered by ascending eigenvalue
+ *
+ * V holds the eigenvector of eigenvalues[j] in column j and must be
+ * column-major, so every eigenvector moves as one contiguous block.
+ */
+EigsymResult sort_eigenpairs(const vec& eigenvalues, const Matrix& V);
+
+/**
+ * @brief Diagonalize the symmetric matrix A with cyclic two-sided Jacobi
+ *
+ * V is the orthogonal transform accumulated so far (the identity for a
+ * cold start); the returned eigenvectors are V times the Jacobi rotations.
+ *
+ * @throws std::runtime_error if the sweeps do not converge
+ */
+EigsymResult jacobi_eigsym(Matrix A, Matrix V);
+
+// === Subspace helpers for the iterative solvers ===
+// All of them work on column-major n x m blocks of column vectors.
+
+/**
+ * @brief Zero-copy view of columns [first, last) of a column-major matrix
+ */
+Matrix column_view(Matrix& M, index_t first, index_t last);
+
+/**
+ * @brief [A, B], the columns of B appended to those of A
+ */
+Matrix concat_columns(const Matrix& A, const Matrix& B);
+
+/**
+ * @brief Orthonormal columns spanning those of T, in order
+ *
+ * Columns that are numerically dependent on earlier ones are dropped, so
+ * the result may have fewer columns. `reference` optionally gives the norm
+ * each column is measured against (default: its norm on entry).
+ */
+Matrix orthonormalize_columns(Matrix T, const vec& reference = {});
+
+/**
+ * @brief Orthonormal basis of the part of span(T) orthogonal to the
+ *        orthonormal columns of V
+ *
+ * Columns of T that lie (numerically) inside span(V) are dropped.
+ */
+Matrix orthonormal_complement(const Matrix& V, Matrix T);
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "matrix.h"
+
+// Low-level building blocks shared by the Matrix kernels. They work on raw
+// contiguous arrays and are written so the compiler can vectorize them.
+
+/**
+ * @brief sum of x[i] * y[i], using four independent accumulators
+ */
+inline double dot_kernel(const double* x, const double* y, std::size_t n) {
+  double acc[4] = {0.0, 0.0, 0.0, 0.0};
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc[0] += x[i] * y[i];
+    acc[1] += x[i + 1] * y[i + 1];
+    acc[2] += x[i + 2] * y[i + 2];
+    acc[3] += x[i + 3] * y[i + 3];
+  }
+  for (; i < n; i++) acc[0] += x[i] * y[i];
+  return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+/**
+ * @brief y[i] += a * x[i]
+ */
+inline void axpy_kernel(double a, const double* x, double* y, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) {
+    y[i] += a * x[i];
+  }
+}
+
+/**
+ * @brief Split rows [0, n) of an upper triangle into `parts` ranges of about
+ *        equal work, where row i holds n - i elements
+ *
+ * Returns parts + 1 boundaries. Depends only on n and parts, so kernels that
+ * combine per-range results stay deterministic.
+ */
+inline std::vector<index_t> upper_triangle_splits(index_t n, index_t parts) {
+  std::vector<index_t> splits(parts + 1, n);
+  splits[0] = 0;
+  double total = 0.5 * n * (n + 1.0);
+  index_t row = 0;
+  double done = 0.0;
+  for (index_t p = 1; p < parts; p++) {
+    double target = total * p / parts;
+    while (row < n && done + (n - row) <= target) {
+      done += n - row;
+      row++;
+    }
+    splits[p] = row;
+  }
+  return splits;
+}
+
+/**
+ * @brief C = A * B for row-major A (m x k) and B (k x n), C is m x n
+ *
+ * Row i of C accumulates A(i, p) * row p of B with contiguous axpy updates;
+ * blocked and split over blocks of rows of C like gemm_tn.
+ */
+void gemm_nn(index_t m, index_t n, index_t k, const double* A, const double* B, double* C);
+
+/**
+ * @brief C = A * B^T for row-major A (m x k) and B (n x k), C is m x n
+ *
+ * Every element is a dot product of two contiguous rows. The loops are
+ * blocked so both row panels stay in cache, and blocks of rows of C are
+ * handed out to the worker threads. With upper_only (m == n) only the
+ * elements C(i, j) with j >= i are written.
+ */
+void gemm_nt(index_t m, index_t n, index_t k, const double* A, const double* B, double* C,
+             bool upper_only = false);
+
+/**
+ * @brief C = A^T * B for row-major A (k x m) and B (k x n), C is m x n
+ *
+ * Row i of C accumulates A(p, i) * row p of B, so B is streamed row by row
+ * and A is read one element per axpy. Blocks of rows of C are handed out to
+ * the worker threads.
+ */
+void gemm_tn(index_t m, index_t n, index_t k, const double* A, const double* B, double* C);
+
+/**
+ * @brief C -= A * B for row-major A (m x k), B (k x n) and C (m x n) with
+ *        row strides lda, ldb and ldc
+ *
+ * The strided form of gemm_nn, for updating a block of a larger array in
+ * place; blocked and split over blocks of rows of C the same way.
+ */
+void gemm_update(index_t m, index_t n, index_t k, const double* A, index_t lda,
+                 const double* B, index_t ldb, double* C, index_t ldc);
+
+/**
+ * @brief C = a * A + b * B^T for row-major A (m x n) and B (n x m)
+ *
+ * Walks both operands in square tiles so the transposed reads stay in cache.
+ */
+void add_transposed(index_t m, index_t n, double a, const double* A, double b, const double* B,
+                    double* C);
+
+/**
+ * @brief C = B^T for row-major B (n x m), C is m x n, copied tile by tile
+ */
+void transpose_kernel(index_t m, index_t n, const double* B, double* C);
+
+/**
+ * @brief Solves op(T) * X = B in place for triangular T (n x n) and
+ *        B (n x m), both row-major with row strides ldt and ldb
+ *
+ * op(T) is T or T^T, `lower` tells which triangle of T is stored and
+ * unit_diagonal takes its diagonal as ones. Every step is an axpy of
+ * contiguous rows of B; the columns of B are split into chunks narrow
+ * enough for a chunk to stay in cache, which the worker threads solve
+ * independently.
+ */
+void trsm(bool lower, bool transpose, bool unit_diagonal, index_t n, index_t m,
+          const double* T, index_t ldt, double* B, index_t ldb);
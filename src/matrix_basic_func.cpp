@@ -1,91 +1,292 @@
 #include "matrix.h"
+#include "kernels.hpp"
 #include <algorithm>
+#include <cstdlib>
+#include <new>
 
-// Constructs an unitialized matrix of given dimension
-Matrix::Matrix(int rows, int cols) : num_rows(rows), num_cols(cols), size(rows*cols), matrix(size) {}
+namespace {
+
+// buffer of count doubles released with free(); calloc hands out large
+// blocks as fresh zero pages, so zeroing costs nothing until first touch
+std::shared_ptr<double> allocate(index_t count, bool zero) {
+  if (count == 0) {
+    return nullptr;
+  }
+  void* p = zero ? std::calloc(count, sizeof(double)) : std::malloc(count * sizeof(double));
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return std::shared_ptr<double>(static_cast<double*>(p), std::free);
+}
+
+// storage that keeps the moved-in vector alive and points at its elements
+std::shared_ptr<double> adopt_vector(vec&& values) {
+  auto holder = std::make_shared<vec>(std::move(values));
+  return std::shared_ptr<double>(holder, holder->data());
+}
+
+} // namespace
+
+// Constructs a zero matrix of given dimension
+Matrix::Matrix(index_t rows, index_t cols, Layout layout)
+  : Matrix(rows, cols, zeroed, layout) {}
+
+Matrix::Matrix(index_t rows, index_t cols, Zeroed, Layout layout)
+  : num_rows(rows), num_cols(cols), size(rows*cols),
+    storage(allocate(size, true)), mem(storage.get()), layout(layout) {}
+
+// Constructs a matrix without writing its elements
+Matrix::Matrix(index_t rows, index_t cols, Uninitialized, Layout layout)
+  : num_rows(rows), num_cols(cols), size(rows*cols),
+    storage(allocate(size, false)), mem(storage.get()), layout(layout) {}
 
 // Default Constructor, creates a 0x0 matrix
 Matrix::Matrix() : num_rows(0), num_cols(0), size(0) {}
 
 // Construct a matrix from an existing flat vector (l-value reference).
-Matrix::Matrix(const vec& values, int rows, int cols)
+Matrix::Matrix(const vec& values, index_t rows, index_t cols, Layout layout)
   : num_rows(rows), 
     num_cols(cols), 
-    size(rows*cols)
+    size(rows*cols),
+    layout(layout)
 {
   // Validate Dimensions
-  if (values.size() != rows * cols) {
+  if (static_cast<index_t>(values.size()) != rows * cols) {
       throw InvalidMatrixSize("Flat vector size does not match requested matrix dimensions");
   }
-  matrix = values;
+  storage = allocate(size, false);
+  mem = storage.get();
+  std::copy(values.begin(), values.end(), mem);
 }
 
-// Construct a matrix from an existing flat vector (r-value reference).
-Matrix::Matrix(vec&& values, int rows, int cols)
+// Construct a matrix from an existing flat vector (r-value reference),
+// taking over its buffer without a copy
+Matrix::Matrix(vec&& values, index_t rows, index_t cols, Layout layout)
   : num_rows(rows), 
     num_cols(cols), 
     size(rows*cols),
-    matrix(std::move(values)) {
+    layout(layout) {
     // Validate Dimensions
-    if (matrix.size() != rows * cols) {
+    if (static_cast<index_t>(values.size()) != rows * cols) {
       throw InvalidMatrixSize("Flat vector size does not match requested matrix dimensions");
     }
+    storage = adopt_vector(std::move(values));
+    mem = storage.get();
   }
 
-// -------------------------------------------------------------------
-// Factory Methods to Fill Matrix Values
-// -------------------------------------------------------------------
+// Copy Constructor, makes an owning copy, or shares the buffer of an
+// owning copy-on-write matrix
+Matrix::Matrix(const Matrix& other)
+  : num_rows(other.num_rows),
+    num_cols(other.num_cols),
+    size(other.size),
+    layout(other.layout),
+    cow(other.cow) {
+  if (cow && other.owns_memory()) {
+    storage = other.storage;
+    mem = other.mem;
+  } else {
+    storage = allocate(size, false);
+    mem = storage.get();
+    std::copy(other.mem, other.mem + size, mem);
+  }
+}
 
-Matrix Matrix::Ones(int rows, int cols) {
-  Matrix M(rows, cols);
-  std::fill(M.matrix.begin(), M.matrix.end(), 1.0);
-  return M;
+// Move Constructor, takes over the storage (or the adopted pointer)
+// and leaves other as an empty 0x0 matrix
+Matrix::Matrix(Matrix&& other) noexcept
+  : num_rows(other.num_rows),
+    num_cols(other.num_cols),
+    size(other.size),
+    storage(std::move(other.storage)),
+    mem(other.mem),
+    layout(other.layout),
+    cow(other.cow) {
+  other.num_rows = other.num_cols = other.size = 0;
+  other.mem = nullptr;
 }
 
-Matrix Matrix::Zeros(int rows, int cols) {
-  Matrix M(rows, cols);
-  std::fill(M.matrix.begin(), M.matrix.end(), 0.0);
+// Write other's elements into the adopted buffer, keeping its layout
+void Matrix::write_adopted(const Matrix& other) {
+  if (other.layout == layout) {
+    std::copy(other.mem, other.mem + size, mem);
+    return;
+  }
+  // other's buffer read row-major is the transpose of ours
+  index_t stored_rows = layout == Layout::RowMajor ? num_rows : num_cols;
+  index_t stored_cols = layout == Layout::RowMajor ? num_cols : num_rows;
+  transpose_kernel(stored_rows, stored_cols, other.mem, mem);
+}
+
+// Copy Assignment
+// An adopting matrix of the same shape is written in place, anything else
+// becomes a copy like in the copy constructor
+Matrix& Matrix::operator=(const Matrix& other) {
+  if (this == &other) {
+    return *this;
+  }
+  if (!owns_memory() && num_rows == other.num_rows && num_cols == other.num_cols) {
+    write_adopted(other);
+    return *this;
+  }
+  // our own unshared buffer of the right size can be reused
+  bool reuse = size == other.size && size > 0 && owns_memory() && storage.use_count() == 1;
+  num_rows = other.num_rows;
+  num_cols = other.num_cols;
+  size = other.size;
+  layout = other.layout;
+  cow = other.cow;
+  if (cow && other.owns_memory()) {
+    storage = other.storage;
+    mem = other.mem;
+    return *this;
+  }
+  if (!reuse) {
+    storage = allocate(size, false);
+    mem = storage.get();
+  }
+  std::copy(other.mem, other.mem + size, mem);
+  return *this;
+}
+
+// Move Assignment, same rule for adopting matrices
+Matrix& Matrix::operator=(Matrix&& other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  if (!owns_memory() && num_rows == other.num_rows && num_cols == other.num_cols) {
+    write_adopted(other);
+    return *this;
+  }
+  num_rows = other.num_rows;
+  num_cols = other.num_cols;
+  size = other.size;
+  storage = std::move(other.storage);
+  mem = other.mem;
+  layout = other.layout;
+  cow = other.cow;
+
+  other.num_rows = other.num_cols = other.size = 0;
+  other.storage.reset();
+  other.mem = nullptr;
+  return *this;
+}
+
+// Adopt external row-major memory without copying
+Matrix Matrix::adopt(double* data, index_t rows, index_t cols, Layout layout) {
+  if (rows < 0 || cols < 0 || (data == nullptr && rows * cols > 0)) {
+    throw InvalidMatrixSize("Adopted memory does not match requested matrix dimensions");
+  }
+  Matrix M;
+  M.num_rows = rows;
+  M.num_cols = cols;
+  M.size = rows * cols;
+  M.mem = data;
+  M.layout = layout;
   return M;
 }
 
-Matrix Matrix::Random(int rows, int cols) {
-  Matrix M(rows, cols);
-  
-  std::random_device rd;
-  std::mt19937 generator(rd());
+// -------------------------------------------------------------------
+// Factory Methods to Fill Matrix Values
+// -------------------------------------------------------------------
 
-  std::uniform_real_distribution<double> distribution(0.0, 1.0);
-  std::generate(M.matrix.begin(), M.matrix.end(), [&]() { return distribution(generator); });
+Matrix Matrix::Ones(index_t rows, index_t cols) {
+  Matrix M(rows, cols, uninitialized);
+  std::fill(M.mem, M.mem + M.size, 1.0);
   return M;
 }
 
-Matrix Matrix::Identity(int n) {
-  Matrix M(n, n);
-  std::fill(M.matrix.begin(), M.matrix.end(), 0.0);
-  for (int i = 0; i < n; i++)
-      M(i, i) = 1.0;
+// calloc already zeroes, nothing left to write
+Matrix Matrix::Zeros(index_t rows, index_t cols) {
+  return Matrix(rows, cols, zeroed);
+}
+
+// Random lives in matrix_random.cpp
+
+Matrix Matrix::Identity(index_t n) {
+  Matrix M(n, n, zeroed);
+  for (index_t i = 0; i < n; i++)
+      M.mem[i * n + i] = 1.0;
   return M;
 }
 
 // -------------------------------------------------------------------
 // Accessors (const getters)
 // -------------------------------------------------------------------
-int Matrix::get_num_rows() const
+index_t Matrix::get_num_rows() const
 {
   return this->num_rows;
 }
 
-int Matrix::get_num_cols() const
+index_t Matrix::get_num_cols() const
 {
   return this->num_cols;
 }
 
-int Matrix::get_size() const
+index_t Matrix::get_size() const
 {
   return this->size;
 }
 
-const vec& Matrix::get_data() const
+DataView Matrix::get_data() const
+{
+  return DataView(mem, size);
+}
+
+vec Matrix::copy_data() const
+{
+  if (layout == Layout::RowMajor) {
+    return vec(mem, mem + size);
+  }
+  vec values(size);
+  transpose_kernel(num_rows, num_cols, mem, values.data());
+  return values;
+}
+
+double* Matrix::memptr()
+{
+  detach();
+  return mem;
+}
+
+const double* Matrix::memptr() const
+{
+  return mem;
+}
+
+Layout Matrix::get_layout() const
+{
+  return layout;
+}
+
+bool Matrix::owns_memory() const
+{
+  return size == 0 || (storage && mem == storage.get());
+}
+
+// -------------------------------------------------------------------
+// Copy-on-write
+// -------------------------------------------------------------------
+void Matrix::clone_storage()
+{
+  std::shared_ptr<double> copy = allocate(size, false);
+  std::copy(mem, mem + size, copy.get());
+  storage = std::move(copy);
+  mem = storage.get();
+}
+
+void Matrix::set_copy_on_write(bool enabled)
+{
+  detach();
+  cow = enabled;
+}
+
+bool Matrix::copy_on_write() const
+{
+  return cow;
+}
+
+bool Matrix::shares_storage_with(const Matrix& other) const
 {
-  return this->matrix;
+  return storage && storage == other.storage;
 }
\ No newline at end of file
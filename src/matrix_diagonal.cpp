@@ -0,0 +1,250 @@
+#include "matrix.h"
+#include "kernels.hpp"
+#include "blas_backend.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Construct from the diagonal entries
+DiagonalMatrix::DiagonalMatrix(const vec& diagonal) : values(diagonal) {}
+
+DiagonalMatrix::DiagonalMatrix(vec&& diagonal) : values(std::move(diagonal)) {}
+
+// -------------------------------------------------------------------
+// Accessors
+// -------------------------------------------------------------------
+index_t DiagonalMatrix::get_num_rows() const
+{
+  return static_cast<index_t>(values.size());
+}
+
+index_t DiagonalMatrix::get_num_cols() const
+{
+  return static_cast<index_t>(values.size());
+}
+
+const vec& DiagonalMatrix::get_diagonal() const
+{
+  return values;
+}
+
+double DiagonalMatrix::operator()(index_t x, index_t y) const {
+  index_t n = get_num_rows();
+  if (x < 0 || x >= n || y < 0 || y >= n) {
+    throw std::out_of_range("Matrix index out of range");
+  }
+  return x == y ? values[x] : 0.0;
+}
+
+// -------------------------------------------------------------------
+// Conversion to a dense matrix
+// -------------------------------------------------------------------
+Matrix DiagonalMatrix::to_dense() const {
+  index_t n = get_num_rows();
+  Matrix result(n, n, Matrix::zeroed);
+  for (index_t i = 0; i < n; i++) {
+    result(i, i) = values[i];
+  }
+  return result;
+}
+
+DiagonalMatrix::operator Matrix() const {
+  return to_dense();
+}
+
+// -------------------------------------------------------------------
+// Products that stay diagonal
+// -------------------------------------------------------------------
+DiagonalMatrix DiagonalMatrix::operator*(const DiagonalMatrix& other) const {
+  if (values.size() != other.values.size()) {
+    throw InvalidMatrixSize("Matrix dimensions incompatible for multiplication");
+  }
+  vec result(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    result[i] = values[i] * other.values[i];
+  }
+  return DiagonalMatrix(std::move(result));
+}
+
+DiagonalMatrix DiagonalMatrix::operator*(double s) const {
+  vec result(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    result[i] = values[i] * s;
+  }
+  return DiagonalMatrix(std::move(result));
+}
+
+vec DiagonalMatrix::operator*(const vec& x) const {
+  if (values.size() != x.size()) {
+    throw InvalidMatrixSize("Vector length must match matrix columns for multiplication");
+  }
+  vec result(values.size());
+  for (size_t i = 0; i < values.size(); i++) {
+    result[i] = values[i] * x[i];
+  }
+  return result;
+}
+
+// -------------------------------------------------------------------
+// Products with dense matrices
+// -------------------------------------------------------------------
+
+namespace {
+
+// row i of a row-major rows x cols array scaled by d[i], written to r
+void scale_rows(index_t rows, index_t cols, const double* a, const double* d, double* r) {
+  std::size_t rows_per_chunk = std::max<std::size_t>(1, elementwise_grain / std::max<index_t>(cols, 1));
+
+  parallel_for(0, rows, rows_per_chunk, [&](std::size_t begin, std::size_t end) {
+    for (index_t i = begin; i < static_cast<index_t>(end); i++) {
+      for (index_t j = 0; j < cols; j++) {
+        r[i * cols + j] = d[i] * a[i * cols + j];
+      }
+    }
+  });
+}
+
+// column j of a row-major rows x cols array scaled by d[j], written to r
+void scale_cols(index_t rows, index_t cols, const double* a, const double* d, double* r) {
+  std::size_t rows_per_chunk = std::max<std::size_t>(1, elementwise_grain / std::max<index_t>(cols, 1));
+
+  parallel_for(0, rows, rows_per_chunk, [&](std::size_t begin, std::size_t end) {
+    for (index_t i = begin; i < static_cast<index_t>(end); i++) {
+      for (index_t j = 0; j < cols; j++) {
+        r[i * cols + j] = a[i * cols + j] * d[j];
+      }
+    }
+  });
+}
+
+} // namespace
+
+// D * A: row i of A scaled by d[i]. The buffer of a column-major A holds
+// A^T row-major, where the rows of A are columns.
+Matrix operator*(const DiagonalMatrix& D, const Matrix& A) {
+  index_t rows = A.get_num_rows();
+  index_t cols = A.get_num_cols();
+  if (D.get_num_cols() != rows) {
+    throw InvalidMatrixSize("Matrix dimensions incompatible for multiplication");
+  }
+  const double* d = D.get_diagonal().data();
+  Matrix result(rows, cols, Matrix::uninitialized, A.get_layout());
+  if (A.get_layout() == Layout::RowMajor) {
+    scale_rows(rows, cols, A.memptr(), d, result.memptr());
+  } else {
+    scale_cols(cols, rows, A.memptr(), d, result.memptr());
+  }
+  return result;
+}
+
+// A * D: column j of A scaled by d[j]
+Matrix operator*(const Matrix& A, const DiagonalMatrix& D) {
+  index_t rows = A.get_num_rows();
+  index_t cols = A.get_num_cols();
+  if (D.get_num_rows() != cols) {
+    throw InvalidMatrixSize("Matrix dimensions incompatible for multiplication");
+  }
+  const double* d = D.get_diagonal().data();
+  Matrix result(rows, cols, Matrix::uninitialized, A.get_layout());
+  if (A.get_layout() == Layout::RowMajor) {
+    scale_cols(rows, cols, A.memptr(), d, result.memptr());
+  } else {
+    scale_rows(cols, rows, A.memptr(), d, result.memptr());
+  }
+  return result;
+}
+
+// A + D and friends only touch the diagonal of a copy of A
+namespace {
+Matrix add_to_diagonal(Matrix A, const DiagonalMatrix& D, double sign) {
+  index_t n = D.get_num_rows();
+  if (A.get_num_rows() != n || A.get_num_cols() != n) {
+    throw InvalidMatrixSize("Matrix sizes must match for addition");
+  }
+  const vec& d = D.get_diagonal();
+  for (index_t i = 0; i < n; i++) {
+    A(i, i) += sign * d[i];
+  }
+  return A;
+}
+}
+
+Matrix operator+(const Matrix& A, const DiagonalMatrix& D) {
+  return add_to_diagonal(A, D, 1.0);
+}
+
+Matrix operator+(const DiagonalMatrix& D, const Matrix& A) {
+  return add_to_diagonal(A, D, 1.0);
+}
+
+Matrix operator-(const Matrix& A, const DiagonalMatrix& D) {
+  return add_to_diagonal(A, D, -1.0);
+}
+
+Matrix operator-(const DiagonalMatrix& D, const Matrix& A) {
+  return add_to_diagonal(A * -1.0, D, 1.0);
+}
+
+// V * D * V^T as A * B^T with A = V |D|^1/2 and B = A sign(D), of which
+// only the upper triangle is formed and then mirrored. Columns with
+// d_j == 0 are left out of A; a NaN d_j is kept (with the positive ones)
+// so that it propagates as in V * D * V^T. On the Blas backend the positive and negative
+// columns of A are two dsyrk updates; natively the row-panel NT kernel
+// forms the upper triangle of A * B^T
+Matrix congruence(const Matrix& V, const DiagonalMatrix& D) {
+  index_t n = V.get_num_rows();
+  if (D.get_num_rows() != V.get_num_cols()) {
+    throw InvalidMatrixSize("Matrix dimensions incompatible for multiplication");
+  }
+  const vec& d = D.get_diagonal();
+  std::vector<index_t> columns;
+  for (index_t j = 0; j < D.get_num_rows(); j++) {
+    if (!(d[j] <= 0.0)) columns.push_back(j);
+  }
+  index_t num_positive = static_cast<index_t>(columns.size());
+  for (index_t j = 0; j < D.get_num_rows(); j++) {
+    if (d[j] < 0.0) columns.push_back(j);
+  }
+  index_t k = static_cast<index_t>(columns.size());
+
+  // A = [V_+ |D_+|^1/2, V_- |D_-|^1/2], row-major n x k
+  const double* v = V.memptr();
+  index_t col_step = V.get_layout() == Layout::RowMajor ? 1 : n;
+  index_t row_step = V.get_layout() == Layout::RowMajor ? V.get_num_cols() : 1;
+  vec A(n * k);
+  vec scale(k);
+  for (index_t c = 0; c < k; c++) {
+    scale[c] = std::sqrt(std::abs(d[columns[c]]));
+  }
+  parallel_for(0, n, std::max<std::size_t>(1, elementwise_grain / std::max<index_t>(k, 1)),
+               [&](std::size_t b, std::size_t e) {
+    for (index_t i = b; i < static_cast<index_t>(e); i++) {
+      for (index_t c = 0; c < k; c++) {
+        A[i * k + c] = v[i * row_step + columns[c] * col_step] * scale[c];
+      }
+    }
+  });
+
+  Matrix result(n, n, Matrix::uninitialized);
+  double* r = result.memptr();
+  if (!(blas_syrk(false, n, num_positive, 1.0, A.data(), k, 0.0, r, n) &&
+        blas_syrk(false, n, k - num_positive, -1.0, A.data() + num_positive, k, 1.0, r, n))) {
+    vec B(A);
+    for (index_t i = 0; i < n; i++) {
+      for (index_t c = num_positive; c < k; c++) {
+        B[i * k + c] = -B[i * k + c];
+      }
+    }
+    if (k == 0) {
+      std::fill(r, r + n * n, 0.0);
+    } else {
+      gemm_nt(n, n, k, A.data(), B.data(), r, true);
+    }
+  }
+
+  for (index_t i = 0; i < n; i++) {
+    for (index_t j = 0; j < i; j++) {
+      r[i * n + j] = r[j * n + i];
+    }
+  }
+  return result;
+}
@@ -1,11 +1,54 @@
 #include "matrix.h"
 #include "helper_func.cpp"
+#include "blas_backend.hpp"
+#include "operand.hpp"
+#include "eigsym_detail.hpp"
+#include "parallel.hpp"
 #include <cmath>
 #include <stdexcept>
 #include <limits>
 #include <algorithm> // for std::sort
 #include <numeric> // for std::iota
 
+namespace {
+
+// elements of the active triangle per parallel part; each element costs two
+// multiply-adds in the symmetric product and two in the rank-2 update
+constexpr std::size_t tridiag_grain = elementwise_grain / 4;
+
+// upper bound on the parts, so the per-part scratch stays O(n)
+constexpr std::size_t tridiag_max_parts = 64;
+
+// number of parts the i x i lower triangle is split into. Depends only on i,
+// so the summation order and the result are the same on any thread count
+std::size_t triangle_parts(index_t i) {
+  std::size_t area = static_cast<std::size_t>(i) * (i + 1) / 2;
+  std::size_t parts = std::min<std::size_t>(area / tridiag_grain, tridiag_max_parts);
+  return std::max<std::size_t>(1, std::min<std::size_t>(parts, i));
+}
+
+// first row of part t when rows [0, i) of a lower triangle are split into
+// parts of equal area: row j costs j + 1, so the boundaries sit near
+// i * sqrt(t / parts) rather than at even row counts
+index_t triangle_boundary(index_t i, std::size_t parts, std::size_t t) {
+  if (t >= parts) return i;
+  return static_cast<index_t>(std::llround(i * std::sqrt(static_cast<double>(t) / parts)));
+}
+
+// a Givens rotation of eigenvector columns col and col + 1, queued by QL
+struct Rotation {
+  index_t col;
+  double c, s;
+};
+
+// rotations queued before they are applied to the eigenvectors
+constexpr std::size_t ql_rotation_batch = 8192;
+
+// elements per row panel of the eigenvector matrix while applying a batch
+constexpr std::size_t ql_panel_elements = 1 << 16;
+
+} // namespace
+
 /* 
 Reduce a real symmetric matrix to tridiagonal form using Householder reflections.
 If yesvecs == true, also accumulate the orthogonal Householder matrix Q.
@@ -13,76 +56,117 @@ Returns:
   d : diagonal entries of tridiagonal matrix
   e : off-diagonal entries of tridiagonal matrix
   Q_house : accumulated Householder transform (if yesvecs) 
+
+Only the lower triangle of the active block is referenced. The symmetric
+product, the rank-2 update and the Q accumulation are split across the
+worker threads; the triangular loops use equal-area row ranges so the parts
+stay balanced as the active block shrinks.
 */
 
 
 TridiagonalResult Matrix::householder_tridiagonalize(bool yesvecs) const {
     TridiagonalResult result;
-    int l, k, j, i;
-    int n = num_rows;
-    Matrix z = *this; // working copy of matrix
+    index_t l, k, j, i;
+    index_t n = num_rows;
+    Matrix z = to_layout(Layout::RowMajor); // working copy of matrix
+    double* a = z.memptr(); // row-major, leading dimension n
     vec e(n), d(n); // d = diagonal, e = off-diagonal of tridiagonal matrix
     double scale, hh, h, g, f;
 
+    // per-part partial sums of the symmetric product
+    vec partial(triangle_parts(n) * n);
+
     // loop of rows/columns starting at the bottom
     for (i = n - 1; i > 0; i--) {
       l = i - 1;
       h = scale = 0.0;
+      double* u = a + i * n; // row i, becomes the reflector
 
       // compute scaling factor
       if (l > 0) {
         for (k = 0; k < i; k++)
-          scale += std::abs(z(i, k));
+          scale += std::abs(u[k]);
 
         // if scale is zero then the column is already populated with zeros
         if (scale == 0.0) {
-          e[i] = z(i, l);
+          e[i] = u[l];
         } else {
           // normalize row by scaling factor and compute the squared norm
           for (k = 0; k < i; k++) {
-            z(i, k) /= scale;
-            h += z(i, k) * z(i, k);
+            u[k] /= scale;
+            h += u[k] * u[k];
           }
 
           // choose reflector direction
-          f = z(i, l);
+          f = u[l];
           g = (f >= 0.0 ? -std::sqrt(h) : std::sqrt(h));
           e[i] = scale * g; // store off-diagonal element
           // update reflector vector
           h -= f * g;
-          z(i, l) = f - g;
+          u[l] = f - g;
+
+          // store for eigenvector accumulation
+          if (yesvecs)
+            for (j = 0; j < i; j++)
+              a[j * n + i] = u[j] / h;
+
+          // p = A u from the lower triangle. Each part walks its rows once,
+          // taking row j against u and scattering row j times u[j] into the
+          // columns, so every access is contiguous
+          std::size_t parts = triangle_parts(i);
+          parallel_for(0, parts, 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t t = first; t < last; t++) {
+              index_t lo = triangle_boundary(i, parts, t);
+              index_t hi = triangle_boundary(i, parts, t + 1);
+              double* p = partial.data() + t * n;
+              std::fill(p, p + hi, 0.0);
+              for (index_t r = lo; r < hi; r++) {
+                const double* row = a + r * n;
+                double ur = u[r];
+                double sum = 0.0;
+                for (index_t c = 0; c < r; c++) {
+                  sum += row[c] * u[c];
+                  p[c] += row[c] * ur;
+                }
+                p[r] += sum + row[r] * ur;
+              }
+            }
+          });
+
+          // combine the parts in order; part t only touched [0, hi)
+          std::fill(e.begin(), e.begin() + i, 0.0);
+          for (std::size_t t = 0; t < parts; t++) {
+            index_t hi = triangle_boundary(i, parts, t + 1);
+            const double* p = partial.data() + t * n;
+            for (j = 0; j < hi; j++)
+              e[j] += p[j];
+          }
           f = 0.0;
-
-          // apply similarity transformation
-          for (j = 0; j < i; j ++) {
-            if (yesvecs)
-              // store for eigenvector accumulation
-              z(j, i) = z(i, j) / h;
-            g = 0.0;
-
-            // compute dot products for transformation
-            for (k = 0; k < j+1; k++)
-              g += z(j, k) * z(i, k);
-            for (k = j + 1; k < i; k++)
-              g += z(k, j) * z(i, k);
-            e[j] = g / h;
-            f += e[j] * z(i, j);
-        }
+          for (j = 0; j < i; j++) {
+            e[j] /= h;
+            f += e[j] * u[j];
+          }
 
         // correction term
         hh = f / (h + h);
+        for (j = 0; j < i; j++)
+          e[j] -= hh * u[j];
 
         // apply rank 2 update
-        for (j = 0; j < i; j++) {
-          f = z(i, j);
-          e[j] = g = e[j] - hh * f;
-
-          for (k = 0; k < j + 1; k++)
-            z(j, k) -= (f * e[k] + g * z(i, k));
-        }
+        parallel_for(0, parts, 1, [&](std::size_t first, std::size_t last) {
+          index_t lo = triangle_boundary(i, parts, first);
+          index_t hi = triangle_boundary(i, parts, last);
+          for (index_t r = lo; r < hi; r++) {
+            double* row = a + r * n;
+            double fr = u[r];
+            double gr = e[r];
+            for (index_t c = 0; c <= r; c++)
+              row[c] -= fr * e[c] + gr * u[c];
+          }
+        });
       }
       } else
-          e[i] = z(i, l); // edge case: single element remains
+          e[i] = u[l]; // edge case: single element remains
         d[i] = h; // store disgonal element
     }
     // initialize first entries
@@ -91,37 +175,51 @@ TridiagonalResult Matrix::householder_tridiagonalize(bool yesvecs) const {
     e[0] = 0.0;
 
     // accumulate householder transformations in Q if yesvecs == true
+    vec w(n);
     for (i = 0; i < n; i++) {
       if (yesvecs) {
         if (d[i] != 0.0) {
-          // apply transformations to earlier columns
-          for (j = 0; j < i; j++) {
-            g = 0.0;
-            for (k = 0; k < i; k++) 
-              g += z(i, k) * z(k, j);
-            for (k = 0; k < i; k++)
-              z(k, j) -= g * z(k, i);
-          }
+          // apply transformations to earlier columns: w = z(i, 0:i) Q, then
+          // Q -= z(0:i, i) w, with Q the leading i x i block
+          const double* zi = a + i * n;
+          std::size_t cols_per_chunk = std::max<std::size_t>(1, elementwise_grain / i);
+          parallel_for(0, i, cols_per_chunk, [&](std::size_t lo, std::size_t hi) {
+            std::fill(w.begin() + lo, w.begin() + hi, 0.0);
+            for (index_t r = 0; r < i; r++) {
+              const double* row = a + r * n;
+              double s = zi[r];
+              for (std::size_t c = lo; c < hi; c++)
+                w[c] += s * row[c];
+            }
+          });
+          parallel_for(0, i, cols_per_chunk, [&](std::size_t lo, std::size_t hi) {
+            for (std::size_t r = lo; r < hi; r++) {
+              double* row = a + r * n;
+              double s = row[i];
+              for (index_t c = 0; c < i; c++)
+                row[c] -= s * w[c];
+            }
+          });
         }
         
         // form Q_house (orthogonal matrix)
-        d[i] = z(i, i);
-        z(i, i) = 1.0;
+        d[i] = a[i * n + i];
+        a[i * n + i] = 1.0;
         for (j = 0; j < i; j++)
-          z(j, i) = z(i, j) = 0.0;
+          a[j * n + i] = a[i * n + j] = 0.0;
 
       } else {
         // only extract diagonal
-        d[i] = z(i, i);
+        d[i] = a[i * n + i];
       }        
     }
 
     if (yesvecs) {
-      result.Q_house = z;
+      result.Q_house = std::move(z);
     }
 
-    result.d = d;
-    result.e = e;
+    result.d = std::move(d);
+    result.e = std::move(e);
 
     return result;
 }
@@ -138,12 +236,42 @@ TridiagonalResult Matrix::householder_tridiagonalize(bool yesvecs) const {
 
 QLEigenResult Matrix::QL(std::vector<double> d, std::vector<double> e) const {
   QLEigenResult result;
-  int n = d.size();
-  int m, l, iter, i, k;
+  index_t n = d.size();
+  index_t m, l, iter, i;
   double s, r, p, g, f, dd, c, b;
   const double eps=std::numeric_limits<double>::epsilon();
 
-  Matrix z = Matrix::Identity(n); // to store eigenvectors
+  // eigenvectors, column-major so the rotations below run over two
+  // contiguous columns
+  Matrix z(n, n, Layout::ColMajor);
+  for (i = 0; i < n; i++) {
+    z(i, i) = 1.0;
+  }
+  double* zp = z.memptr();
+
+  // The rotations never read z, so they are buffered and applied in
+  // batches: each row panel of z takes the whole batch in order while it
+  // is cache resident, and the panels are independent so they run in
+  // parallel. Every element still sees the same rotations in the same
+  // order, so the result is unchanged.
+  std::vector<Rotation> rotations;
+  rotations.reserve(ql_rotation_batch);
+  std::size_t panel_rows = std::max<std::size_t>(64, ql_panel_elements / n);
+  auto apply_rotations = [&]() {
+    parallel_for(0, n, panel_rows, [&](std::size_t r0, std::size_t r1) {
+      for (const Rotation& rot : rotations) {
+        double* zi = zp + rot.col * n;
+        double* zi1 = zi + n;
+        const double c = rot.c, s = rot.s; // locals, zi may alias rot
+        for (std::size_t k = r0; k < r1; k++) {
+          double t = zi1[k];
+          zi1[k] = s * zi[k] + c * t;
+          zi[k] = c * zi[k] - s * t;
+        }
+      }
+    });
+    rotations.clear();
+  };
 
   // shift e so that e[i] is subdiagonal between d[i] and d[i+1]
   for (i = 1; i < n; i++) {
@@ -188,12 +316,9 @@ QLEigenResult Matrix::QL(std::vector<double> d, std::vector<double> e) const {
           d[i+1]  = g + (p=s*r);
           g = c*r - b;
           
-          // apply rotation to eigenvector matrix
-          for ( k=0; k<n; k++ ) {
-            f = z(k, i+1);
-            z(k, i+1) = s*z(k, i)+c*f;
-            z(k, i) = c*z(k, i)-s*f;
-          }
+          // queue the rotation of eigenvector columns i and i+1
+          rotations.push_back({i, c, s});
+          if (rotations.size() == ql_rotation_batch) apply_rotations();
 
         }
 
@@ -207,65 +332,94 @@ QLEigenResult Matrix::QL(std::vector<double> d, std::vector<double> e) const {
     } while ( m != l );
   }
 
-  result.eigenvalues = d;
-  result.Q_ql = z;
+  apply_rotations();
+
+  result.eigenvalues = std::move(d);
+  result.Q_ql = std::move(z);
   return result;
 }
 
-// Compute eigenvalues and eigenvectors of a real symmetric matrix.
-// Pipeline:
-//   Householder tridiagonalization -> QL eigensolver -> combine transforms
-
-EigsymResult Matrix::eigsym() const {
-  // make sure matrix is square
-  if (num_rows != num_cols) {
-    throw InvalidMatrixSize("householder_tridiagonalize requires a square matrix");
-  }
-
-  // make sure matrix is symmetric
-  if (!is_symmetric(1e-8)) {
-    throw InvalidMatrixSize("Matrix must be symmetric for eigsym()");
-  }
-    
-  // reduce matrix to tridiagonal form
-  TridiagonalResult tri = householder_tridiagonalize(true);
-
-  // apply QL to solve for eigenvalues and eigenvectors
-  QLEigenResult ql = QL(tri.d, tri.e);
-
-  // combine householder and QL eigenvectors
-  Matrix P = tri.Q_house * ql.Q_ql;
-
-  vec eigenvalues = ql.eigenvalues; // copy so eigenvalues can be reordered to match Armadillo
-  int n = static_cast<int>(eigenvalues.size());
+// Reorder eigenpairs by ascending eigenvalue, moving whole columns of V
+EigsymResult sort_eigenpairs(const vec& eigenvalues, const Matrix& V) {
+  index_t n = static_cast<index_t>(eigenvalues.size());
 
   // build index array
-  std::vector<int> idx(n);
+  std::vector<index_t> idx(n);
   std::iota(idx.begin(), idx.end(), 0);
 
-
   // sort indices by eigenvalue (ascending)
-  std::sort(idx.begin(), idx.end(), [&](int i, int j) {
+  std::sort(idx.begin(), idx.end(), [&](index_t i, index_t j) {
     return eigenvalues[i] < eigenvalues[j];
   });
 
   // build sorted eigenvalues and eigenvectors
   vec eigenvalues_sorted(n);
-  Matrix P_sorted(n, n);
+  Matrix V_sorted(n, n, Matrix::uninitialized, Layout::ColMajor);
 
-  for (int k = 0; k < n; ++k) {
-    int j = idx[k];  // original eigenpair index
+  for (index_t k = 0; k < n; ++k) {
+    index_t j = idx[k];  // original eigenpair index
     eigenvalues_sorted[k] = eigenvalues[j];
 
-    // copy column j of P into column k of P_sorted
-    for (int row = 0; row < n; ++row) {
-      P_sorted(row, k) = P(row, j);
-    }
+    // copy column j of V into column k of V_sorted (both contiguous)
+    std::copy(V.memptr() + j * n, V.memptr() + (j + 1) * n, V_sorted.memptr() + k * n);
   }
 
   EigsymResult result;
   result.eigenvalues  = std::move(eigenvalues_sorted);
-  result.eigenvectors = std::move(P_sorted);
-
+  result.eigenvectors = std::move(V_sorted);
   return result;
-}
\ No newline at end of file
+}
+
+// Compute eigenvalues and eigenvectors of a real symmetric matrix.
+// Pipeline:
+//   Householder tridiagonalization -> QL eigensolver -> combine transforms
+
+EigsymResult Matrix::eigsym(bool check_symmetric) const {
+  return eigsym(EigsymMethod::Default, check_symmetric);
+}
+
+EigsymResult Matrix::eigsym(EigsymMethod method, bool check_symmetric) const {
+  // make sure matrix is square
+  if (num_rows != num_cols) {
+    throw InvalidMatrixSize("householder_tridiagonalize requires a square matrix");
+  }
+
+  // make sure matrix is symmetric, unless the caller vouches for it
+  if (check_symmetric && !is_symmetric(1e-8)) {
+    throw InvalidMatrixSize("Matrix must be symmetric for eigsym()");
+  }
+
+  if (method == EigsymMethod::Jacobi) {
+    Matrix V(num_rows, num_rows, Matrix::zeroed, Layout::ColMajor);
+    for (index_t i = 0; i < num_rows; i++) {
+      V(i, i) = 1.0;
+    }
+    return jacobi_eigsym(*this, std::move(V));
+  }
+
+  // vendor path: dsyevd returns ascending eigenvalues and the eigenvectors
+  // as the columns of the column-major work array
+  if (method == EigsymMethod::Default && get_backend() == Backend::Blas) {
+    vec work(mem, mem + size);
+    vec w(num_rows);
+    if (lapack_syevd(num_rows, work.data(), w.data())) {
+      EigsymResult result;
+      result.eigenvalues = std::move(w);
+      result.eigenvectors = Matrix(std::move(work), num_rows, num_cols, Layout::ColMajor);
+      return result;
+    }
+  }
+    
+  // reduce matrix to tridiagonal form
+  TridiagonalResult tri = householder_tridiagonalize(true);
+
+  // apply QL to solve for eigenvalues and eigenvectors
+  QLEigenResult ql = QL(std::move(tri.d), std::move(tri.e));
+
+  // combine householder and QL eigenvectors, column-major so that every
+  // eigenvector is contiguous
+  index_t n = num_rows;
+  Matrix P = multiply(operand(tri.Q_house), operand(ql.Q_ql), n, n, n, Layout::ColMajor);
+
+  return sort_eigenpairs(ql.eigenvalues, P);
+}
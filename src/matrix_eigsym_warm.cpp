@@ -0,0 +1,286 @@
+#include "matrix.h"
+#include "eigsym_detail.hpp"
+#include "operand.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// -------------------------------------------------------------------
+// Subspace helpers, shared with the Davidson solver (eigsym_detail.hpp)
+// -------------------------------------------------------------------
+
+Matrix column_view(Matrix& M, index_t first, index_t last) {
+  index_t n = M.get_num_rows();
+  return Matrix::adopt(M.memptr() + first * n, n, last - first, Layout::ColMajor);
+}
+
+Matrix concat_columns(const Matrix& A, const Matrix& B) {
+  index_t n = A.get_num_rows();
+  Matrix C(n, A.get_num_cols() + B.get_num_cols(), Matrix::uninitialized, Layout::ColMajor);
+  std::copy(A.memptr(), A.memptr() + A.get_size(), C.memptr());
+  std::copy(B.memptr(), B.memptr() + B.get_size(), C.memptr() + A.get_size());
+  return C;
+}
+
+// Modified Gram-Schmidt in two passes. A column is dropped when less than
+// 1e-10 of its norm in `reference` (its norm on entry if empty) survives,
+// i.e. when it is numerically inside the span of the columns before it
+Matrix orthonormalize_columns(Matrix T, const vec& reference) {
+  index_t n = T.get_num_rows();
+  index_t m = T.get_num_cols();
+  double* t = T.memptr();
+  index_t kept = 0;
+  for (index_t j = 0; j < m; j++) {
+    double* col = t + kept * n;
+    if (kept != j) {
+      std::copy(t + j * n, t + (j + 1) * n, col);
+    }
+    double norm0 = 0.0;
+    for (index_t i = 0; i < n; i++) norm0 += col[i] * col[i];
+    if (!reference.empty()) {
+      norm0 = reference[j] * reference[j];
+    }
+    for (int pass = 0; pass < 2; pass++) {
+      for (index_t c = 0; c < kept; c++) {
+        const double* q = t + c * n;
+        double dot = 0.0;
+        for (index_t i = 0; i < n; i++) dot += q[i] * col[i];
+        for (index_t i = 0; i < n; i++) col[i] -= dot * q[i];
+      }
+    }
+    double norm = 0.0;
+    for (index_t i = 0; i < n; i++) norm += col[i] * col[i];
+    if (!(norm > 1e-20 * norm0)) {
+      continue;
+    }
+    double inv = 1.0 / std::sqrt(norm);
+    for (index_t i = 0; i < n; i++) col[i] *= inv;
+    kept++;
+  }
+  if (kept == m) {
+    return T;
+  }
+  return Matrix(vec(t, t + kept * n), n, kept, Layout::ColMajor);
+}
+
+// Block projection T - V (V^T T), applied twice so the rounding left by the
+// first pass is removed as well, then Gram-Schmidt within T. Dropping is
+// judged against the norms before the projection
+Matrix orthonormal_complement(const Matrix& V, Matrix T) {
+  index_t n = T.get_num_rows();
+  index_t m = V.get_num_cols();
+  index_t b = T.get_num_cols();
+  vec norms(b);
+  for (index_t j = 0; j < b; j++) {
+    const double* col = T.memptr() + j * n;
+    double sq = 0.0;
+    for (index_t i = 0; i < n; i++) sq += col[i] * col[i];
+    norms[j] = std::sqrt(sq);
+  }
+  for (int pass = 0; pass < 2 && m > 0; pass++) {
+    Matrix P = multiply(operand(V.t()), operand(T), m, b, n, Layout::ColMajor);
+    T = combine(1.0, operand(T), -1.0, operand(multiply(operand(V), operand(P), n, b, m, Layout::ColMajor)),
+                n, b, Layout::ColMajor);
+  }
+  return orthonormalize_columns(std::move(T), norms);
+}
+
+namespace {
+
+constexpr int warm_max_iterations = 10;
+
+// the basis grows by k vectors per iteration up to this many times k
+constexpr index_t warm_max_basis = 4;
+
+// converged once every residual ||A x - theta x|| is below this times ||A||_F
+constexpr double warm_residual_tol = 1e3 * std::numeric_limits<double>::epsilon();
+
+// an iteration that does not at least halve the largest residual has stalled
+constexpr double warm_stall_ratio = 0.5;
+
+// the lowest k eigenpairs of a full decomposition
+EigsymResult leading_eigenpairs(EigsymResult full, index_t k) {
+  index_t n = full.eigenvectors.get_num_rows();
+  if (k == n) {
+    return full;
+  }
+  full.eigenvalues.resize(k);
+  const double* v = full.eigenvectors.memptr();
+  full.eigenvectors = Matrix(vec(v, v + k * n), n, k, Layout::ColMajor);
+  return full;
+}
+
+} // namespace
+
+/*
+ Warm-started eigensolver for a sequence of slowly changing matrices.
+ The previous eigenpairs (V0, d0), the lowest p >= k of them, supply both
+ the starting subspace and the preconditioner:
+
+   1. Rayleigh-Ritz in Z = V0(:, 0:k): H = Z^T A Z is nearly diagonal, so
+      it is finished with Jacobi sweeps, which converge in one or two sweeps.
+   2. While some residual r_i = A x_i - theta_i x_i is too large, expand the
+      basis with t_i = V0c (d0c - theta_i)^-1 V0c^T r_i + (D - theta_i)^-1 w_i,
+      and repeat Rayleigh-Ritz in the basis grown by T (restarted from
+      [X, T] once it would exceed 4k vectors). The first term corrects r_i in
+      V0c = V0(:, k:p) with the old spectrum; the second corrects the part
+      w_i = (I - V0 V0^T) r_i outside the old eigenvectors with the diagonal
+      D of A, as in Davidson. With a full guess (p = n) w_i vanishes, and
+      with p = k, such as the result of the previous call, only the Davidson
+      term is left.
+
+ Each iteration costs a few n x n x k products, against O(n^3) for a full
+ decomposition, and the residual drops roughly by ||A - F0|| / gap per
+ iteration. When an iteration fails to halve the residual the full solver
+ runs instead, so a poor guess costs time but never accuracy.
+
+ Rotating all of A into the old basis (k = n) and finishing with Jacobi
+ sweeps is not cheaper than a fresh decomposition: the sweeps are memory
+ bound and cost more than a LAPACK solve. Above n / 4 wanted eigenpairs the
+ subspace iterations stop paying off as well, so those go to eigsym().
+*/
+EigsymResult Matrix::eigsym_warm(const EigsymResult& guess, index_t num_eigenpairs,
+                                 bool check_symmetric) const {
+  index_t n = num_rows;
+  if (num_rows != num_cols) {
+    throw InvalidMatrixSize("eigsym_warm requires a square matrix");
+  }
+  if (num_eigenpairs < 1 || num_eigenpairs > n) {
+    throw InvalidMatrixSize("eigsym_warm: num_eigenpairs must be between 1 and n");
+  }
+  index_t p = guess.eigenvectors.get_num_cols();
+  if (guess.eigenvectors.get_num_rows() != n || p < num_eigenpairs || p > n ||
+      static_cast<index_t>(guess.eigenvalues.size()) != p) {
+    throw InvalidMatrixSize("eigsym_warm: guess must hold at least num_eigenpairs eigenpairs");
+  }
+  if (check_symmetric && !is_symmetric(1e-8)) {
+    throw InvalidMatrixSize("Matrix must be symmetric for eigsym_warm()");
+  }
+
+  index_t k = num_eigenpairs;
+  if (k > n / 4) {
+    return leading_eigenpairs(eigsym(false), k);
+  }
+  Matrix V0 = guess.eigenvectors.to_layout(Layout::ColMajor);
+  const vec& d0 = guess.eigenvalues;
+  vec diagonal(n);
+  if (p < n) {
+    for (index_t i = 0; i < n; i++) diagonal[i] = (*this)(i, i);
+  }
+
+  double scale = std::max(norm_fro(), std::numeric_limits<double>::min());
+  double tol = warm_residual_tol * scale;
+  // keeps the preconditioner finite when an old eigenvalue meets a Ritz value
+  double min_gap = 1e-8 * scale;
+
+  Matrix Z = orthonormalize_columns(column_view(V0, 0, k).to_layout(Layout::ColMajor));
+  if (Z.get_num_cols() < k) {
+    return leading_eigenpairs(eigsym(false), k);
+  }
+  Matrix AZ = multiply(operand(*this), operand(Z), n, k, n, Layout::ColMajor);
+
+  double previous_residual = std::numeric_limits<double>::infinity();
+  for (int iter = 0; iter < warm_max_iterations; iter++) {
+    // Rayleigh-Ritz in span(Z), symmetrized against rounding
+    index_t m = Z.get_num_cols();
+    Matrix H = multiply(operand(Z.t()), operand(AZ), m, m, n, Layout::ColMajor);
+    double* h = H.memptr();
+    for (index_t j = 0; j < m; j++) {
+      for (index_t i = j + 1; i < m; i++) {
+        h[i + j * m] = h[j + i * m] = 0.5 * (h[i + j * m] + h[j + i * m]);
+      }
+    }
+    EigsymResult ritz;
+    if (iter == 0) {
+      Matrix I(m, m, Matrix::zeroed, Layout::ColMajor);
+      for (index_t i = 0; i < m; i++) I(i, i) = 1.0;
+      ritz = jacobi_eigsym(std::move(H), std::move(I));
+    } else {
+      ritz = H.eigsym(EigsymMethod::Default, false);
+    }
+    Matrix Y = column_view(ritz.eigenvectors, 0, k);
+    Matrix X = multiply(operand(Z), operand(Y), n, k, m, Layout::ColMajor);
+    Matrix AX = multiply(operand(AZ), operand(Y), n, k, m, Layout::ColMajor);
+    ritz.eigenvalues.resize(k);
+    const vec& theta = ritz.eigenvalues;
+
+    // residuals R = A X - X diag(theta), one per column
+    Matrix R(n, k, Matrix::uninitialized, Layout::ColMajor);
+    double residual = 0.0;
+    for (index_t j = 0; j < k; j++) {
+      const double* x = X.memptr() + j * n;
+      const double* ax = AX.memptr() + j * n;
+      double* r = R.memptr() + j * n;
+      double sq = 0.0;
+      for (index_t i = 0; i < n; i++) {
+        r[i] = ax[i] - theta[j] * x[i];
+        sq += r[i] * r[i];
+      }
+      residual = std::max(residual, std::sqrt(sq));
+    }
+    if (residual <= tol) {
+      EigsymResult result;
+      result.eigenvalues = theta;
+      result.eigenvectors = std::move(X);
+      return result;
+    }
+    if (residual > warm_stall_ratio * previous_residual) {
+      break;
+    }
+    previous_residual = residual;
+
+    // a gap between an eigenvalue estimate and a Ritz value, kept away from 0
+    auto safe_gap = [min_gap](double gap) {
+      if (std::abs(gap) < min_gap) {
+        gap = gap < 0.0 ? -min_gap : min_gap;
+      }
+      return gap;
+    };
+
+    // G = V0^T R; the part of R outside the old eigenvectors, W = R - V0 G,
+    // is needed before G is overwritten
+    Matrix G = multiply(operand(V0.t()), operand(R), p, k, n, Layout::ColMajor);
+    Matrix W;
+    if (p < n) {
+      W = combine(1.0, operand(R), -1.0, operand(multiply(operand(V0), operand(G), n, k, p, Layout::ColMajor)),
+                  n, k, Layout::ColMajor);
+    }
+
+    // corrections in V0c: T = V0 C, where C(j, i) = G(j, i) / (d0[j] - theta_i)
+    // for j >= k and zero for the columns of V0 that started the basis
+    double* g = G.memptr();
+    for (index_t i = 0; i < k; i++) {
+      for (index_t j = 0; j < p; j++) {
+        g[j + i * p] = j < k ? 0.0 : g[j + i * p] / safe_gap(d0[j] - theta[i]);
+      }
+    }
+    Matrix T = multiply(operand(V0), operand(G), n, k, p, Layout::ColMajor);
+
+    // and outside V0: t_i += (D - theta_i)^-1 w_i
+    if (p < n) {
+      double* t = T.memptr();
+      const double* w = W.memptr();
+      for (index_t i = 0; i < k; i++) {
+        for (index_t j = 0; j < n; j++) {
+          t[j + i * n] += w[j + i * n] / safe_gap(diagonal[j] - theta[i]);
+        }
+      }
+    }
+
+    // with the full old spectrum one correction per Ritz vector suffices,
+    // so restart from [X, T]; the Davidson term needs the basis to grow
+    bool restart = p == n || m + k > warm_max_basis * k;
+    T = orthonormal_complement(restart ? X : Z, std::move(T));
+    if (T.get_num_cols() == 0) {
+      break;
+    }
+
+    Matrix AT = multiply(operand(*this), operand(T), n, T.get_num_cols(), n, Layout::ColMajor);
+    Z = concat_columns(restart ? X : Z, T);
+    AZ = concat_columns(restart ? AX : AZ, AT);
+  }
+
+  // stalled: start over from scratch
+  return leading_eigenpairs(eigsym(false), k);
+}
@@ -0,0 +1,504 @@
+#include "factorizations.hpp"
+#include "kernels.hpp"
+#include "blas_backend.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// block sizes of the blocked Cholesky and LU; the trailing updates are
+// rank-64
+constexpr index_t cholesky_block = 64;
+constexpr index_t lu_block = 64;
+// column tile of the native trailing update, so that the panel slice it
+// reads (cholesky_block x trailing_tile) stays in L2 across rows
+constexpr index_t trailing_tile = 256;
+
+Matrix row_major(const Matrix& M) {
+  return M.get_layout() == Layout::RowMajor ? M : M.to_layout(Layout::RowMajor);
+}
+
+void check_square(const Matrix& A, bool check_symmetric, const char* name) {
+  if (A.get_num_rows() != A.get_num_cols()) {
+    throw InvalidMatrixSize(std::string(name) + " requires a square matrix");
+  }
+  if (check_symmetric && !A.is_symmetric(1e-8)) {
+    throw InvalidMatrixSize(std::string("Matrix must be symmetric for ") + name);
+  }
+}
+
+void check_rhs(index_t n, const Matrix& B) {
+  if (B.get_num_rows() != n) {
+    throw InvalidMatrixSize("Right-hand side rows must match the factored matrix");
+  }
+}
+
+void check_rhs(index_t n, const vec& b) {
+  if (static_cast<index_t>(b.size()) != n) {
+    throw InvalidMatrixSize("Right-hand side length must match the factored matrix");
+  }
+}
+
+// solutions come back in the layout of the right-hand side
+Matrix in_layout_of(Matrix X, const Matrix& B) {
+  return B.get_layout() == Layout::RowMajor ? X : X.to_layout(B.get_layout());
+}
+
+// unblocked upper Cholesky of the kb x kb diagonal block at a
+void cholesky_unblocked(double* a, index_t kb, index_t ld) {
+  for (index_t j = 0; j < kb; j++) {
+    double* row = a + j * ld;
+    if (!(row[j] > 0.0)) {
+      throw std::domain_error("CholeskyFactor: matrix is not positive definite");
+    }
+    double r = std::sqrt(row[j]);
+    row[j] = r;
+    double inv = 1.0 / r;
+    for (index_t c = j + 1; c < kb; c++) row[c] *= inv;
+    for (index_t i = j + 1; i < kb; i++) {
+      axpy_kernel(-row[i], row + i, a + i * ld + i, kb - i);
+    }
+  }
+}
+
+// A22 -= U12^T U12 on the upper triangle, with U12 the kb x m panel at u and
+// A22 the m x m trailing matrix at c, both with row stride ld
+void trailing_update(const double* u, index_t kb, index_t m, double* c, index_t ld) {
+  if (blas_syrk(true, m, kb, -1.0, u, ld, 1.0, c, ld)) {
+    return;
+  }
+  // number of blocks depends on m only, never on the thread count
+  double work = 0.5 * m * (m + 1.0) * kb;
+  index_t parts = static_cast<index_t>(std::min<double>(32.0, std::ceil(work / elementwise_grain)));
+  parts = std::max<index_t>(1, std::min(parts, m));
+  std::vector<index_t> splits = upper_triangle_splits(m, parts);
+
+  parallel_for(0, parts, 1, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t part = begin; part < end; part++) {
+      index_t r0 = splits[part];
+      index_t r1 = splits[part + 1];
+      for (index_t c0 = r0; c0 < m; c0 += trailing_tile) {
+        index_t c1 = std::min(m, c0 + trailing_tile);
+        for (index_t i = r0; i < std::min(r1, c1); i++) {
+          index_t j0 = std::max(i, c0);
+          double* ci = c + i * ld;
+          for (index_t p = 0; p < kb; p++) {
+            const double* up = u + p * ld;
+            axpy_kernel(-up[i], up + j0, ci + j0, c1 - j0);
+          }
+        }
+      }
+    }
+  });
+}
+
+} // namespace
+
+Matrix solve_triangular(const Matrix& T, const Matrix& B, Triangle uplo,
+                        bool transpose, bool unit_diagonal) {
+  index_t n = T.get_num_rows();
+  if (T.get_num_cols() != n) {
+    throw InvalidMatrixSize("solve_triangular requires a square matrix");
+  }
+  check_rhs(n, B);
+  Matrix Tr = row_major(T);
+  Matrix X = row_major(B);
+  index_t m = X.get_num_cols();
+  trsm(uplo == Triangle::Lower, transpose, unit_diagonal, n, m, Tr.memptr(), n, X.memptr(), m);
+  return in_layout_of(std::move(X), B);
+}
+
+vec solve_triangular(const Matrix& T, const vec& b, Triangle uplo,
+                     bool transpose, bool unit_diagonal) {
+  return solve_triangular(T, Matrix(b, static_cast<index_t>(b.size()), 1), uplo, transpose,
+                          unit_diagonal).copy_data();
+}
+
+// -------------------------------------------------------------------
+// Cholesky
+// -------------------------------------------------------------------
+CholeskyFactor::CholeskyFactor(const Matrix& A, bool check_symmetric) {
+  check_square(A, check_symmetric, "CholeskyFactor");
+  index_t n = A.get_num_rows();
+  U = row_major(A);
+  double* a = U.memptr();
+
+  // right-looking by block rows: factor the diagonal block, solve the
+  // panel U11^T U12 = A12, then A22 -= U12^T U12
+  for (index_t k0 = 0; k0 < n; k0 += cholesky_block) {
+    index_t k1 = std::min(n, k0 + cholesky_block);
+    index_t kb = k1 - k0;
+    double* diag = a + k0 * n + k0;
+    cholesky_unblocked(diag, kb, n);
+    if (k1 == n) {
+      break;
+    }
+    trsm(false, true, false, kb, n - k1, diag, n, a + k0 * n + k1, n);
+    trailing_update(a + k0 * n + k1, kb, n - k1, a + k1 * n + k1, n);
+  }
+
+  for (index_t i = 1; i < n; i++) {
+    std::fill(a + i * n, a + i * n + i, 0.0);
+  }
+}
+
+index_t CholeskyFactor::size() const {
+  return U.get_num_rows();
+}
+
+const Matrix& CholeskyFactor::upper() const {
+  return U;
+}
+
+Matrix CholeskyFactor::lower() const {
+  return U.transpose();
+}
+
+Matrix CholeskyFactor::solve(const Matrix& B) const {
+  index_t n = size();
+  check_rhs(n, B);
+  Matrix X = row_major(B);
+  index_t m = X.get_num_cols();
+  trsm(false, true, false, n, m, U.memptr(), n, X.memptr(), m);
+  trsm(false, false, false, n, m, U.memptr(), n, X.memptr(), m);
+  return in_layout_of(std::move(X), B);
+}
+
+vec CholeskyFactor::solve(const vec& b) const {
+  check_rhs(size(), b);
+  return solve(Matrix(b, size(), 1)).copy_data();
+}
+
+Matrix CholeskyFactor::inverse() const {
+  Matrix X = solve(Matrix::Identity(size()));
+  return (X + X.transpose()) * 0.5;
+}
+
+double CholeskyFactor::log_det() const {
+  double sum = 0.0;
+  for (index_t i = 0; i < size(); i++) {
+    sum += std::log(U(i, i));
+  }
+  return 2.0 * sum;
+}
+
+// -------------------------------------------------------------------
+// Bunch-Kaufman LDL^T
+// -------------------------------------------------------------------
+LDLTFactor::LDLTFactor(const Matrix& A, bool check_symmetric) {
+  check_square(A, check_symmetric, "LDLTFactor");
+  index_t n = A.get_num_rows();
+  L = row_major(A);
+  double* a = L.memptr();
+  auto at = [a, n](index_t i, index_t j) -> double& { return a[i * n + j]; };
+
+  d.assign(n, 0.0);
+  e.assign(n, 0.0);
+  perm.resize(n);
+  std::iota(perm.begin(), perm.end(), 0);
+  // the pivot columns, copied out so the row updates read them contiguously
+  vec c0(n);
+  vec c1(n);
+  const double alpha = (1.0 + std::sqrt(17.0)) / 8.0;
+
+  index_t k = 0;
+  while (k < n) {
+    double absakk = std::abs(at(k, k));
+    index_t r = k;
+    double colmax = 0.0;
+    for (index_t i = k + 1; i < n; i++) {
+      if (std::abs(at(i, k)) > colmax) {
+        colmax = std::abs(at(i, k));
+        r = i;
+      }
+    }
+    if (std::max(absakk, colmax) == 0.0) {
+      throw std::runtime_error("LDLTFactor: matrix is singular");
+    }
+
+    // Bunch-Kaufman: keep a_kk when it is large enough against its column,
+    // else pivot on a_rr, else take the 2x2 block of k and r
+    index_t kstep = 1;
+    index_t kp = k;
+    if (absakk < alpha * colmax) {
+      double rowmax = 0.0;
+      for (index_t j = k; j < r; j++) rowmax = std::max(rowmax, std::abs(at(r, j)));
+      for (index_t j = r + 1; j < n; j++) rowmax = std::max(rowmax, std::abs(at(j, r)));
+      if (absakk * rowmax >= alpha * colmax * colmax) {
+        kp = k;
+      } else if (std::abs(at(r, r)) >= alpha * rowmax) {
+        kp = r;
+      } else {
+        kp = r;
+        kstep = 2;
+      }
+    }
+
+    // symmetric interchange of kk and kp on the lower triangle; the rows of
+    // the finished columns of L are swapped too, so one permutation covers
+    // the whole factorization
+    index_t kk = k + kstep - 1;
+    if (kp != kk) {
+      std::swap_ranges(&at(kk, 0), &at(kk, kk), &at(kp, 0));
+      std::swap(at(kk, kk), at(kp, kp));
+      for (index_t j = kk + 1; j < kp; j++) std::swap(at(j, kk), at(kp, j));
+      for (index_t j = kp + 1; j < n; j++) std::swap(at(j, kk), at(j, kp));
+      std::swap(perm[kk], perm[kp]);
+    }
+
+    index_t first = k + kstep;
+    std::size_t grain = std::max<std::size_t>(1, elementwise_grain / std::max<index_t>(n - first, 1));
+    if (kstep == 1) {
+      double dk = at(k, k);
+      d[k] = dk;
+      for (index_t i = first; i < n; i++) c0[i] = at(i, k);
+      parallel_for(first, n, grain, [&](std::size_t begin, std::size_t end) {
+        for (index_t i = begin; i < static_cast<index_t>(end); i++) {
+          double l = c0[i] / dk;
+          axpy_kernel(-l, c0.data() + first, &at(i, first), i - first + 1);
+          at(i, k) = l;
+        }
+      });
+    } else {
+      double d11 = at(k, k);
+      double d21 = at(k + 1, k);
+      double d22 = at(k + 1, k + 1);
+      double det = d11 * d22 - d21 * d21;
+      d[k] = d11;
+      d[k + 1] = d22;
+      e[k] = d21;
+      at(k + 1, k) = 0.0;
+      for (index_t i = first; i < n; i++) {
+        c0[i] = at(i, k);
+        c1[i] = at(i, k + 1);
+      }
+      parallel_for(first, n, grain, [&](std::size_t begin, std::size_t end) {
+        for (index_t i = begin; i < static_cast<index_t>(end); i++) {
+          // [l0 l1] = [a_ik a_ik+1] D^-1
+          double l0 = (c0[i] * d22 - c1[i] * d21) / det;
+          double l1 = (c1[i] * d11 - c0[i] * d21) / det;
+          axpy_kernel(-l0, c0.data() + first, &at(i, first), i - first + 1);
+          axpy_kernel(-l1, c1.data() + first, &at(i, first), i - first + 1);
+          at(i, k) = l0;
+          at(i, k + 1) = l1;
+        }
+      });
+    }
+    k += kstep;
+  }
+
+  for (index_t i = 0; i < n; i++) {
+    at(i, i) = 1.0;
+    std::fill(&at(i, 0) + i + 1, &at(i, 0) + n, 0.0);
+  }
+}
+
+index_t LDLTFactor::size() const {
+  return L.get_num_rows();
+}
+
+const Matrix& LDLTFactor::lower() const {
+  return L;
+}
+
+Matrix LDLTFactor::block_diagonal() const {
+  index_t n = size();
+  Matrix D(n, n, Matrix::zeroed);
+  for (index_t i = 0; i < n; i++) {
+    D(i, i) = d[i];
+    if (e[i] != 0.0) {
+      D(i + 1, i) = D(i, i + 1) = e[i];
+    }
+  }
+  return D;
+}
+
+const std::vector<index_t>& LDLTFactor::permutation() const {
+  return perm;
+}
+
+Matrix LDLTFactor::solve(const Matrix& B) const {
+  index_t n = size();
+  check_rhs(n, B);
+  Matrix Br = row_major(B);
+  index_t m = Br.get_num_cols();
+  Matrix X(n, m, Matrix::uninitialized);
+  double* x = X.memptr();
+  for (index_t i = 0; i < n; i++) {
+    std::copy_n(Br.memptr() + perm[i] * m, m, x + i * m);
+  }
+
+  trsm(true, false, true, n, m, L.memptr(), n, x, m);
+  for (index_t i = 0; i < n; i++) {
+    double* xi = x + i * m;
+    if (e[i] == 0.0) {
+      double inv = 1.0 / d[i];
+      for (index_t c = 0; c < m; c++) xi[c] *= inv;
+      continue;
+    }
+    double* xj = xi + m;
+    double det = d[i] * d[i + 1] - e[i] * e[i];
+    for (index_t c = 0; c < m; c++) {
+      double u = xi[c];
+      double v = xj[c];
+      xi[c] = (d[i + 1] * u - e[i] * v) / det;
+      xj[c] = (d[i] * v - e[i] * u) / det;
+    }
+    i++;
+  }
+  trsm(true, true, true, n, m, L.memptr(), n, x, m);
+
+  double* out = Br.memptr();
+  for (index_t i = 0; i < n; i++) {
+    std::copy_n(x + i * m, m, out + perm[i] * m);
+  }
+  return in_layout_of(std::move(Br), B);
+}
+
+vec LDLTFactor::solve(const vec& b) const {
+  check_rhs(size(), b);
+  return solve(Matrix(b, size(), 1)).copy_data();
+}
+
+Matrix LDLTFactor::inverse() const {
+  Matrix X = solve(Matrix::Identity(size()));
+  return (X + X.transpose()) * 0.5;
+}
+
+index_t LDLTFactor::num_negative() const {
+  index_t count = 0;
+  for (index_t i = 0; i < size(); i++) {
+    if (e[i] == 0.0) {
+      count += d[i] < 0.0;
+      continue;
+    }
+    // a 2x2 block has eigenvalues of either sign when det < 0
+    double det = d[i] * d[i + 1] - e[i] * e[i];
+    count += det < 0.0 ? 1 : (d[i] + d[i + 1] < 0.0 ? 2 : 0);
+    i++;
+  }
+  return count;
+}
+
+// -------------------------------------------------------------------
+// LU with partial pivoting
+// -------------------------------------------------------------------
+LUFactor::LUFactor(const Matrix& A) {
+  if (A.get_num_rows() != A.get_num_cols()) {
+    throw InvalidMatrixSize("LUFactor requires a square matrix");
+  }
+  index_t n = A.get_num_rows();
+  LU = row_major(A);
+  double* a = LU.memptr();
+  perm.resize(n);
+  std::iota(perm.begin(), perm.end(), 0);
+
+  for (index_t k0 = 0; k0 < n; k0 += lu_block) {
+    index_t k1 = std::min(n, k0 + lu_block);
+    index_t kb = k1 - k0;
+
+    // unblocked panel: interchanges swap whole rows, so they reach the
+    // finished columns of L and the not yet updated columns on the right
+    std::size_t grain = std::max<std::size_t>(1, elementwise_grain / kb);
+    for (index_t j = k0; j < k1; j++) {
+      index_t p = j;
+      for (index_t i = j + 1; i < n; i++) {
+        if (std::abs(a[i * n + j]) > std::abs(a[p * n + j])) p = i;
+      }
+      if (p != j) {
+        std::swap_ranges(a + j * n, a + (j + 1) * n, a + p * n);
+        std::swap(perm[j], perm[p]);
+        parity = -parity;
+      }
+      double pivot = a[j * n + j];
+      if (pivot == 0.0) {
+        // the rest of the column is zero too; U gets a zero diagonal
+        continue;
+      }
+      const double* uj = a + j * n + j + 1;
+      parallel_for(j + 1, n, grain, [&](std::size_t begin, std::size_t end) {
+        for (index_t i = begin; i < static_cast<index_t>(end); i++) {
+          double* ai = a + i * n;
+          double l = ai[j] / pivot;
+          ai[j] = l;
+          axpy_kernel(-l, uj, ai + j + 1, k1 - j - 1);
+        }
+      });
+    }
+    if (k1 == n) {
+      break;
+    }
+
+    // U12 = L11^-1 A12, then A22 -= L21 U12
+    trsm(true, false, true, kb, n - k1, a + k0 * n + k0, n, a + k0 * n + k1, n);
+    gemm_update(n - k1, n - k1, kb, a + k1 * n + k0, n, a + k0 * n + k1, n, a + k1 * n + k1, n);
+  }
+}
+
+index_t LUFactor::size() const {
+  return LU.get_num_rows();
+}
+
+Matrix LUFactor::lower() const {
+  index_t n = size();
+  Matrix L(n, n, Matrix::zeroed);
+  for (index_t i = 0; i < n; i++) {
+    for (index_t j = 0; j < i; j++) L(i, j) = LU(i, j);
+    L(i, i) = 1.0;
+  }
+  return L;
+}
+
+Matrix LUFactor::upper() const {
+  index_t n = size();
+  Matrix U(n, n, Matrix::zeroed);
+  for (index_t i = 0; i < n; i++) {
+    for (index_t j = i; j < n; j++) U(i, j) = LU(i, j);
+  }
+  return U;
+}
+
+const std::vector<index_t>& LUFactor::permutation() const {
+  return perm;
+}
+
+Matrix LUFactor::solve(const Matrix& B) const {
+  index_t n = size();
+  check_rhs(n, B);
+  for (index_t i = 0; i < n; i++) {
+    if (LU(i, i) == 0.0) {
+      throw std::runtime_error("LUFactor: matrix is singular");
+    }
+  }
+  Matrix Br = row_major(B);
+  index_t m = Br.get_num_cols();
+  Matrix X(n, m, Matrix::uninitialized);
+  double* x = X.memptr();
+  for (index_t i = 0; i < n; i++) {
+    std::copy_n(Br.memptr() + perm[i] * m, m, x + i * m);
+  }
+  trsm(true, false, true, n, m, LU.memptr(), n, x, m);
+  trsm(false, false, false, n, m, LU.memptr(), n, x, m);
+  return in_layout_of(std::move(X), B);
+}
+
+vec LUFactor::solve(const vec& b) const {
+  check_rhs(size(), b);
+  return solve(Matrix(b, size(), 1)).copy_data();
+}
+
+Matrix LUFactor::inverse() const {
+  return solve(Matrix::Identity(size()));
+}
+
+double LUFactor::det() const {
+  double product = parity;
+  for (index_t i = 0; i < size(); i++) {
+    product *= LU(i, i);
+  }
+  return product;
+}
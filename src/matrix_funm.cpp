@@ -0,0 +1,76 @@
+#include "matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// Functions of symmetric matrices, f(A) = V diag(f(w)) V^T. One
+// eigendecomposition, then congruence() forms the result from one triangle.
+
+namespace {
+
+// V diag(fw) V^T for the eigenvectors of eig
+Matrix from_eigenpairs(const EigsymResult& eig, const vec& fw) {
+  return congruence(eig.eigenvectors, DiagonalMatrix(fw));
+}
+
+// Eigenvalues of a positive semidefinite matrix come out slightly negative
+// from rounding, by up to about n * eps * max|w|. Anything below that and
+// below -threshold means the matrix is indefinite
+void check_semidefinite(const vec& w, double threshold, const char* name) {
+  if (w.empty()) {
+    return;
+  }
+  double scale = std::max(std::abs(w.front()), std::abs(w.back()));
+  double rounding = static_cast<double>(w.size()) * std::numeric_limits<double>::epsilon() * scale;
+  if (w.front() < -std::max(rounding, threshold)) {
+    throw std::domain_error(std::string(name) + ": matrix is not positive semidefinite");
+  }
+}
+
+} // namespace
+
+Matrix Matrix::funm_sym(const std::function<double(double)>& f, bool check_symmetric) const {
+  EigsymResult eig = eigsym(check_symmetric);
+  vec fw(eig.eigenvalues.size());
+  std::transform(eig.eigenvalues.begin(), eig.eigenvalues.end(), fw.begin(), f);
+  return from_eigenpairs(eig, fw);
+}
+
+Matrix Matrix::sqrtm_sym(double threshold) const {
+  EigsymResult eig = eigsym();
+  check_semidefinite(eig.eigenvalues, threshold, "sqrtm_sym");
+  vec fw(eig.eigenvalues.size());
+  for (std::size_t i = 0; i < fw.size(); i++) {
+    double w = eig.eigenvalues[i];
+    fw[i] = w > threshold ? std::sqrt(w) : 0.0;
+  }
+  return from_eigenpairs(eig, fw);
+}
+
+Matrix Matrix::invsqrtm_sym(double threshold) const {
+  EigsymResult eig = eigsym();
+  check_semidefinite(eig.eigenvalues, threshold, "invsqrtm_sym");
+  vec fw(eig.eigenvalues.size());
+  for (std::size_t i = 0; i < fw.size(); i++) {
+    double w = eig.eigenvalues[i];
+    fw[i] = w > threshold ? 1.0 / std::sqrt(w) : 0.0;
+  }
+  return from_eigenpairs(eig, fw);
+}
+
+Matrix Matrix::expm_sym() const {
+  return funm_sym([](double w) { return std::exp(w); });
+}
+
+Matrix Matrix::logm_sym() const {
+  EigsymResult eig = eigsym();
+  if (!eig.eigenvalues.empty() && !(eig.eigenvalues.front() > 0.0)) {
+    throw std::domain_error("logm_sym: matrix is not positive definite");
+  }
+  vec fw(eig.eigenvalues.size());
+  for (std::size_t i = 0; i < fw.size(); i++) {
+    fw[i] = std::log(eig.eigenvalues[i]);
+  }
+  return from_eigenpairs(eig, fw);
+}
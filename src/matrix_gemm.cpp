@@ -0,0 +1,235 @@
+#include "kernels.hpp"
+#include "blas_backend.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+
+// Cache blocking for the row-panel kernels: a block of C is mb x nb and the
+// two operand panels are mb x kb and nb x kb (128 KiB each, about L2 size).
+namespace {
+const index_t mb = 64;
+const index_t nb = 64;
+const index_t kb = 256;
+
+// columns of C per block in gemm_nn and gemm_tn, so a kb x jb panel of B (512 KiB) is
+// reused by every row of the block
+const index_t jb = 256;
+
+// square tiles for the transposed elementwise kernels, 8 KiB per operand
+const index_t tile = 32;
+
+// rows of C per chunk, a multiple of the tile height
+std::size_t tile_rows_per_chunk(index_t n) {
+  std::size_t rows = elementwise_grain / std::max<index_t>(n, 1);
+  return std::max<std::size_t>(tile, rows / tile * tile);
+}
+}
+
+void gemm_nn(index_t m, index_t n, index_t k, const double* A, const double* B, double* C) {
+  if (blas_gemm(false, false, m, n, k, A, B, C)) {
+    return;
+  }
+  index_t row_blocks = (m + mb - 1) / mb;
+
+  parallel_for(0, row_blocks, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t blk = first; blk < last; blk++) {
+      index_t i0 = blk * mb;
+      index_t i1 = std::min(m, i0 + mb);
+      std::fill(C + i0 * n, C + i1 * n, 0.0);
+
+      for (index_t k0 = 0; k0 < k; k0 += kb) {
+        index_t k1 = std::min(k, k0 + kb);
+
+        for (index_t j0 = 0; j0 < n; j0 += jb) {
+          index_t jlen = std::min(n, j0 + jb) - j0;
+
+          for (index_t i = i0; i < i1; i++) {
+            const double* a = A + i * k;
+            double* c = C + i * n + j0;
+            for (index_t p = k0; p < k1; p++) {
+              axpy_kernel(a[p], B + p * n + j0, c, jlen);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void gemm_update(index_t m, index_t n, index_t k, const double* A, index_t lda,
+                 const double* B, index_t ldb, double* C, index_t ldc) {
+  if (blas_gemm_update(m, n, k, A, lda, B, ldb, C, ldc)) {
+    return;
+  }
+  index_t row_blocks = (m + mb - 1) / mb;
+
+  parallel_for(0, row_blocks, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t blk = first; blk < last; blk++) {
+      index_t i0 = blk * mb;
+      index_t i1 = std::min(m, i0 + mb);
+
+      for (index_t k0 = 0; k0 < k; k0 += kb) {
+        index_t k1 = std::min(k, k0 + kb);
+
+        for (index_t j0 = 0; j0 < n; j0 += jb) {
+          index_t jlen = std::min(n, j0 + jb) - j0;
+
+          for (index_t i = i0; i < i1; i++) {
+            const double* a = A + i * lda;
+            double* c = C + i * ldc + j0;
+            for (index_t p = k0; p < k1; p++) {
+              axpy_kernel(-a[p], B + p * ldb + j0, c, jlen);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void gemm_nt(index_t m, index_t n, index_t k, const double* A, const double* B, double* C,
+             bool upper_only) {
+  // the backend fills all of C, a superset of what upper_only asks for
+  if (blas_gemm(false, true, m, n, k, A, B, C)) {
+    return;
+  }
+  index_t row_blocks = (m + mb - 1) / mb;
+
+  // one block of rows per chunk; chunks are pulled dynamically, which also
+  // balances the shrinking rows of the upper_only case
+  parallel_for(0, row_blocks, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t blk = first; blk < last; blk++) {
+      index_t i0 = blk * mb;
+      index_t i1 = std::min(m, i0 + mb);
+
+      for (index_t i = i0; i < i1; i++) {
+        index_t j_first = upper_only ? i : 0;
+        std::fill(C + i * n + j_first, C + (i + 1) * n, 0.0);
+      }
+
+      for (index_t k0 = 0; k0 < k; k0 += kb) {
+        index_t klen = std::min(k, k0 + kb) - k0;
+
+        for (index_t j0 = upper_only ? i0 : 0; j0 < n; j0 += nb) {
+          index_t j1 = std::min(n, j0 + nb);
+
+          for (index_t i = i0; i < i1; i++) {
+            const double* a = A + i * k + k0;
+            double* c = C + i * n;
+            for (index_t j = upper_only ? std::max(j0, i) : j0; j < j1; j++) {
+              c[j] += dot_kernel(a, B + j * k + k0, klen);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void gemm_tn(index_t m, index_t n, index_t k, const double* A, const double* B, double* C) {
+  if (blas_gemm(true, false, m, n, k, A, B, C)) {
+    return;
+  }
+  index_t row_blocks = (m + mb - 1) / mb;
+
+  parallel_for(0, row_blocks, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t blk = first; blk < last; blk++) {
+      index_t i0 = blk * mb;
+      index_t i1 = std::min(m, i0 + mb);
+      std::fill(C + i0 * n, C + i1 * n, 0.0);
+
+      for (index_t k0 = 0; k0 < k; k0 += kb) {
+        index_t k1 = std::min(k, k0 + kb);
+
+        for (index_t j0 = 0; j0 < n; j0 += jb) {
+          index_t jlen = std::min(n, j0 + jb) - j0;
+
+          for (index_t i = i0; i < i1; i++) {
+            double* c = C + i * n + j0;
+            for (index_t p = k0; p < k1; p++) {
+              axpy_kernel(A[p * m + i], B + p * n + j0, c, jlen);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void add_transposed(index_t m, index_t n, double a, const double* A, double b, const double* B,
+                    double* C) {
+  parallel_for(0, m, tile_rows_per_chunk(n), [&](std::size_t first, std::size_t last) {
+    for (index_t i0 = first; i0 < static_cast<index_t>(last); i0 += tile) {
+      index_t i1 = std::min(static_cast<index_t>(last), i0 + tile);
+      for (index_t j0 = 0; j0 < n; j0 += tile) {
+        index_t j1 = std::min(n, j0 + tile);
+        for (index_t i = i0; i < i1; i++) {
+          for (index_t j = j0; j < j1; j++) {
+            C[i * n + j] = a * A[i * n + j] + b * B[j * m + i];
+          }
+        }
+      }
+    }
+  });
+}
+
+void transpose_kernel(index_t m, index_t n, const double* B, double* C) {
+  parallel_for(0, m, tile_rows_per_chunk(n), [&](std::size_t first, std::size_t last) {
+    for (index_t i0 = first; i0 < static_cast<index_t>(last); i0 += tile) {
+      index_t i1 = std::min(static_cast<index_t>(last), i0 + tile);
+      for (index_t j0 = 0; j0 < n; j0 += tile) {
+        index_t j1 = std::min(n, j0 + tile);
+        for (index_t i = i0; i < i1; i++) {
+          for (index_t j = j0; j < j1; j++) {
+            C[i * n + j] = B[j * m + i];
+          }
+        }
+      }
+    }
+  });
+}
+
+void trsm(bool lower, bool transpose, bool unit_diagonal, index_t n, index_t m,
+          const double* T, index_t ldt, double* B, index_t ldb) {
+  if (blas_trsm(lower, transpose, unit_diagonal, n, m, T, ldt, B, ldb)) {
+    return;
+  }
+  // T^T of a lower T is upper, so the solve runs forward for a lower op(T)
+  // and backward otherwise
+  bool forward = lower != transpose;
+  std::size_t width = std::max<std::size_t>(16, elementwise_grain / std::max<index_t>(n, 1));
+
+  parallel_for(0, m, width, [&](std::size_t first, std::size_t last) {
+    index_t c0 = first;
+    index_t w = last - first;
+    auto row = [&](index_t i) { return B + i * ldb + c0; };
+    for (index_t step = 0; step < n; step++) {
+      index_t i = forward ? step : n - 1 - step;
+      const double* t = T + i * ldt;
+      double* x = row(i);
+      if (!transpose) {
+        // left-looking: row i of T holds the coefficients of the solved rows
+        index_t p0 = forward ? 0 : i + 1;
+        index_t p1 = forward ? i : n;
+        for (index_t p = p0; p < p1; p++) {
+          axpy_kernel(-t[p], row(p), x, w);
+        }
+        if (!unit_diagonal) {
+          double inv = 1.0 / t[i];
+          for (index_t c = 0; c < w; c++) x[c] *= inv;
+        }
+      } else {
+        // right-looking: row i of T is column i of op(T), applied to the
+        // rows still to be solved once x_i is final
+        if (!unit_diagonal) {
+          double inv = 1.0 / t[i];
+          for (index_t c = 0; c < w; c++) x[c] *= inv;
+        }
+        index_t p0 = forward ? i + 1 : 0;
+        index_t p1 = forward ? n : i;
+        for (index_t p = p0; p < p1; p++) {
+          axpy_kernel(-t[p], x, row(p), w);
+        }
+      }
+    }
+  });
+}
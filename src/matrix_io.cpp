@@ -0,0 +1,205 @@
+#include "matrix.h"
+#include "text_buffer.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// characters between columns when writing
+char separator(TextFormat format) {
+  switch (format) {
+    case TextFormat::CSV: return ',';
+    case TextFormat::TSV: return '\t';
+    default: return ' ';
+  }
+}
+
+// characters that may pad a field when reading (the separator itself is never padding)
+bool is_blank(char c, TextFormat format) {
+  if (c == '\t') return format != TextFormat::TSV;
+  return c == ' ' || c == '\r';
+}
+
+void write_value(TextBuffer& buffer, double x, int precision) {
+  if (precision < 0) {
+    buffer.put_roundtrip(x);
+  } else {
+    buffer.put_general(x, precision);
+  }
+}
+
+// rough output size so small matrices don't allocate a full buffer block
+size_t size_estimate(size_t count, int precision) {
+  return count * (precision < 0 ? 25 : std::min(precision, TextBuffer::max_significant_digits) + 9);
+}
+
+// parse a single value starting at p, returns one past the last character used
+const char* parse_value(const char* p, const char* eol, double& x, size_t line) {
+  if (p < eol && *p == '+') ++p; // from_chars does not accept a leading '+'
+  auto res = std::from_chars(p, eol, x);
+  if (res.ec != std::errc() || res.ptr == p) {
+    throw std::runtime_error("Could not parse matrix value on line " + std::to_string(line));
+  }
+  return res.ptr;
+}
+
+// parse all values on [p, eol) into values, returns the number of columns found
+index_t parse_row(const char* p, const char* eol, TextFormat format, vec& values, size_t line) {
+  const char sep = separator(format);
+  index_t count = 0;
+
+  while (true) {
+    while (p < eol && is_blank(*p, format)) ++p;
+
+    if (p == eol) {
+      // a blank line has no columns, but a trailing separator is a missing value
+      if (count > 0 && format != TextFormat::Whitespace) {
+        throw std::runtime_error("Missing matrix value on line " + std::to_string(line));
+      }
+      return count;
+    }
+
+    double x;
+    p = parse_value(p, eol, x, line);
+    values.push_back(x);
+    count++;
+
+    if (format == TextFormat::Whitespace) {
+      if (p < eol && !is_blank(*p, format)) {
+        throw std::runtime_error("Could not parse matrix value on line " + std::to_string(line));
+      }
+    } else {
+      while (p < eol && is_blank(*p, format)) ++p;
+      if (p == eol) return count;
+      if (*p != sep) {
+        throw std::runtime_error("Could not parse matrix value on line " + std::to_string(line));
+      }
+      ++p;
+    }
+  }
+}
+
+// read the rest of the stream into one string
+std::string read_all(std::istream& in) {
+  std::string text;
+  std::streampos start = in.tellg();
+  if (start != std::streampos(-1) && in.seekg(0, std::ios::end)) {
+    std::streampos stop = in.tellg();
+    in.seekg(start);
+    text.resize(static_cast<size_t>(stop - start));
+    in.read(&text[0], text.size());
+    text.resize(static_cast<size_t>(in.gcount()));
+  } else {
+    // not seekable (pipes etc.), fall back to copying the stream buffer
+    in.clear();
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    text = ss.str();
+  }
+  return text;
+}
+
+} // namespace
+
+// Write matrix as delimited text, one row per line
+void Matrix::write_text(std::ostream& out, const Matrix& data,
+                        TextFormat format, int precision)
+{
+  if (data.get_layout() != Layout::RowMajor) {
+    write_text(out, data.to_layout(Layout::RowMajor), format, precision);
+    return;
+  }
+  const char sep = separator(format);
+  const double* m = data.memptr();
+  index_t rows = data.get_num_rows();
+  index_t cols = data.get_num_cols();
+
+  TextBuffer buffer(out, size_estimate(data.get_size(), precision));
+  for (index_t i = 0; i < rows; i++) {
+    for (index_t j = 0; j < cols; j++) {
+      if (j > 0) buffer.put(sep);
+      write_value(buffer, m[i * cols + j], precision);
+    }
+    buffer.put('\n');
+  }
+}
+
+// Write vector as a column, one value per line; no delimiter, so the
+// format does not matter
+void Matrix::write_text(std::ostream& out, const vec& data,
+                        TextFormat /*format*/, int precision)
+{
+  TextBuffer buffer(out, size_estimate(data.size(), precision));
+  for (double x : data) {
+    write_value(buffer, x, precision);
+    buffer.put('\n');
+  }
+}
+
+void Matrix::save_text(const Matrix& data, const std::string& filename,
+                       TextFormat format, int precision)
+{
+  std::ofstream out(filename, std::ios::binary);
+  if (!out) {
+    throw std::runtime_error("Could not open " + filename + " for writing");
+  }
+  write_text(out, data, format, precision);
+}
+
+void Matrix::save_text(const vec& data, const std::string& filename,
+                       TextFormat format, int precision)
+{
+  std::ofstream out(filename, std::ios::binary);
+  if (!out) {
+    throw std::runtime_error("Could not open " + filename + " for writing");
+  }
+  write_text(out, data, format, precision);
+}
+
+// Parse a delimited text matrix, one row per non-empty line
+Matrix Matrix::read_text(std::istream& in, TextFormat format) {
+  std::string text = read_all(in);
+
+  vec values;
+  index_t rows = 0;
+  index_t cols = 0;
+  size_t line = 1;
+
+  const char* p = text.data();
+  const char* end = p + text.size();
+
+  while (p < end) {
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if (eol == nullptr) eol = end;
+
+    index_t count = parse_row(p, eol, format, values, line);
+    if (count > 0) {
+      if (rows == 0) {
+        cols = count;
+        // assume the other rows are about as long as the first to avoid regrowing
+        size_t row_bytes = static_cast<size_t>(eol - p) + 1;
+        values.reserve((text.size() / row_bytes + 1) * cols);
+      } else if (count != cols) {
+        throw InvalidMatrixSize("Line " + std::to_string(line) + " has " + std::to_string(count)
+                                + " values but previous rows have " + std::to_string(cols));
+      }
+      rows++;
+    }
+
+    p = eol + 1;
+    line++;
+  }
+
+  return Matrix(std::move(values), rows, cols);
+}
+
+Matrix Matrix::load_text(const std::string& filename, TextFormat format) {
+  std::ifstream in(filename, std::ios::binary);
+  if (!in) {
+    throw std::runtime_error("Could not open " + filename + " for reading");
+  }
+  return read_text(in, format);
+}
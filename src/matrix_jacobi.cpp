@@ -0,0 +1,143 @@
+#include "matrix.h"
+#include "eigsym_detail.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// rotation of the pair (p, q), p < q, with J(p,p) = J(q,q) = c and
+// J(p,q) = -J(q,p) = s; A <- J^T A J zeroes A(p,q)
+struct JacobiRotation {
+  index_t p, q;
+  double c, s;
+};
+
+constexpr int jacobi_max_sweeps = 60;
+
+} // namespace
+
+/*
+ Cyclic two-sided Jacobi with round-robin ordering.
+ Each sweep visits every pair (p, q) once, grouped into rounds of n/2
+ disjoint pairs by the round-robin tournament schedule. Rotations within a
+ round commute, so a round is applied as one parallel pass over the rows of
+ A and the columns of V, followed by one parallel pass over the columns of A.
+
+ A pair is skipped when |A(p,q)| <= eps * sqrt(|A(p,p) A(q,q)|). Measuring
+ against the diagonal rather than the norm of A keeps the small eigenvalues
+ of graded positive definite matrices to high relative accuracy, and a
+ nearly diagonal A converges in one or two sweeps.
+*/
+EigsymResult jacobi_eigsym(Matrix A, Matrix V) {
+  index_t n = A.get_num_rows();
+  if (A.get_layout() != Layout::RowMajor) {
+    A = A.to_layout(Layout::RowMajor);
+  }
+  if (V.get_layout() != Layout::ColMajor) {
+    V = V.to_layout(Layout::ColMajor);
+  }
+  double* a = A.memptr(); // full symmetric matrix, rows contiguous
+  double* v = V.memptr(); // eigenvectors, columns contiguous
+  const double eps = std::numeric_limits<double>::epsilon();
+
+  // round-robin schedule for an even number of players m (a dummy player
+  // when n is odd): round pairs players[k] with players[m - 1 - k], and
+  // rotating every player but the first between rounds meets each pair
+  // exactly once in m - 1 rounds
+  index_t m = n + n % 2;
+  std::vector<index_t> players(m);
+  std::iota(players.begin(), players.end(), 0);
+
+  std::vector<JacobiRotation> rotations;
+  rotations.reserve(m / 2);
+  std::size_t pairs_per_chunk = std::max<std::size_t>(1, elementwise_grain / (4 * std::max<index_t>(n, 1)));
+
+  bool converged = n < 2;
+  for (int sweep = 0; sweep < jacobi_max_sweeps && !converged; sweep++) {
+    converged = true;
+    for (index_t round = 0; round < m - 1; round++) {
+      rotations.clear();
+      for (index_t k = 0; k < m / 2; k++) {
+        index_t p = std::min(players[k], players[m - 1 - k]);
+        index_t q = std::max(players[k], players[m - 1 - k]);
+        if (q >= n) {
+          continue; // paired with the dummy player
+        }
+        double apq = a[p * n + q];
+        double app = a[p * n + p];
+        double aqq = a[q * n + q];
+        if (std::abs(apq) <= eps * std::sqrt(std::abs(app)) * std::sqrt(std::abs(aqq))) {
+          continue;
+        }
+        // smaller root of t^2 + 2 theta t - 1 = 0, Rutishauser's formulation
+        double theta = (aqq - app) / (2.0 * apq);
+        double t = 1.0 / (std::abs(theta) + std::hypot(1.0, theta));
+        if (theta < 0.0) {
+          t = -t;
+        }
+        double c = 1.0 / std::sqrt(1.0 + t * t);
+        rotations.push_back({p, q, c, t * c});
+      }
+      std::rotate(players.begin() + 1, players.end() - 1, players.end());
+
+      if (rotations.empty()) {
+        continue;
+      }
+      converged = false;
+
+      // A <- J^T A on rows p and q, and V <- V J on columns p and q; the
+      // pairs are disjoint, so each is an independent task
+      parallel_for(0, rotations.size(), pairs_per_chunk, [&](std::size_t first, std::size_t last) {
+        for (std::size_t r = first; r < last; r++) {
+          const double c = rotations[r].c, s = rotations[r].s;
+          double* ap = a + rotations[r].p * n;
+          double* aq = a + rotations[r].q * n;
+          double* vp = v + rotations[r].p * n;
+          double* vq = v + rotations[r].q * n;
+          for (index_t j = 0; j < n; j++) {
+            double x = ap[j], y = aq[j];
+            ap[j] = c * x - s * y;
+            aq[j] = s * x + c * y;
+          }
+          for (index_t j = 0; j < n; j++) {
+            double x = vp[j], y = vq[j];
+            vp[j] = c * x - s * y;
+            vq[j] = s * x + c * y;
+          }
+        }
+      });
+
+      // A <- A J on columns p and q, row by row so each row of A is read once
+      std::size_t rows_per_chunk = std::max<std::size_t>(1, elementwise_grain / (2 * rotations.size()));
+      parallel_for(0, n, rows_per_chunk, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) {
+          double* row = a + i * n;
+          for (const JacobiRotation& rot : rotations) {
+            double x = row[rot.p], y = row[rot.q];
+            row[rot.p] = rot.c * x - rot.s * y;
+            row[rot.q] = rot.s * x + rot.c * y;
+          }
+        }
+      });
+
+      // the rotated pairs are zero up to rounding
+      for (const JacobiRotation& rot : rotations) {
+        a[rot.p * n + rot.q] = a[rot.q * n + rot.p] = 0.0;
+      }
+    }
+  }
+  if (!converged) {
+    throw std::runtime_error("eigsym: Jacobi sweeps did not converge");
+  }
+
+  vec w(n);
+  for (index_t i = 0; i < n; i++) {
+    w[i] = a[i * n + i];
+  }
+  return sort_eigenpairs(w, V);
+}
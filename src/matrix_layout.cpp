@@ -0,0 +1,91 @@
+#include "matrix.h"
+#include "kernels.hpp"
+#include "operand.hpp"
+#include <memory>
+
+// -------------------------------------------------------------------
+// Layout conversion
+// -------------------------------------------------------------------
+Matrix Matrix::to_layout(Layout target) const {
+  if (target == layout) {
+    return *this;
+  }
+  // the buffer read row-major is stored_rows x stored_cols
+  index_t stored_rows = layout == Layout::RowMajor ? num_rows : num_cols;
+  index_t stored_cols = layout == Layout::RowMajor ? num_cols : num_rows;
+  Matrix result(num_rows, num_cols, uninitialized, target);
+  transpose_kernel(stored_cols, stored_rows, mem, result.mem);
+  return result;
+}
+
+// -------------------------------------------------------------------
+// Dispatch onto the row-major kernels
+// -------------------------------------------------------------------
+namespace {
+
+// row-major op(A) * op(B) into C (m x n); every kernel writes all of C
+void multiply_rowmajor(Operand A, Operand B, index_t m, index_t n, index_t k, double* C) {
+  if (!A.trans && !B.trans) {
+    gemm_nn(m, n, k, A.data, B.data, C);
+  } else if (!A.trans) {
+    gemm_nt(m, n, k, A.data, B.data, C);
+  } else if (!B.trans) {
+    gemm_tn(m, n, k, A.data, B.data, C);
+  } else {
+    // A^T B^T = (B A)^T: one product, then a tiled transpose
+    std::unique_ptr<double[]> Ct(new double[m * n]);
+    gemm_nn(n, m, k, B.data, A.data, Ct.get());
+    transpose_kernel(m, n, Ct.get(), C);
+  }
+}
+
+// row-major a * op(X) + b * op(Y) into C (m x n)
+void combine_rowmajor(double a, Operand X, double b, Operand Y, index_t m, index_t n, double* C) {
+  if (X.trans == Y.trans) {
+    // with both buffers transposed the flat sum is (a X + b Y)^T, staged
+    // in a scratch buffer and transposed into C
+    std::unique_ptr<double[]> scratch(X.trans ? new double[m * n] : nullptr);
+    double* c = X.trans ? scratch.get() : C;
+    const double* x = X.data;
+    const double* y = Y.data;
+    parallel_for(0, m * n, elementwise_grain, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t i = begin; i < end; i++) {
+        c[i] = a * x[i] + b * y[i];
+      }
+    });
+    if (X.trans) {
+      transpose_kernel(m, n, c, C);
+    }
+  } else if (!X.trans) {
+    add_transposed(m, n, a, X.data, b, Y.data, C);
+  } else {
+    add_transposed(m, n, b, Y.data, a, X.data, C);
+  }
+}
+
+Operand flipped(Operand op) {
+  return {op.data, !op.trans};
+}
+
+} // namespace
+
+// results are written in full, so they start uninitialized
+Matrix multiply(Operand A, Operand B, index_t m, index_t n, index_t k, Layout layout) {
+  Matrix C(m, n, Matrix::uninitialized, layout);
+  if (layout == Layout::ColMajor) {
+    multiply_rowmajor(flipped(B), flipped(A), n, m, k, C.memptr());
+  } else {
+    multiply_rowmajor(A, B, m, n, k, C.memptr());
+  }
+  return C;
+}
+
+Matrix combine(double a, Operand X, double b, Operand Y, index_t m, index_t n, Layout layout) {
+  Matrix C(m, n, Matrix::uninitialized, layout);
+  if (layout == Layout::ColMajor) {
+    combine_rowmajor(a, flipped(X), b, flipped(Y), n, m, C.memptr());
+  } else {
+    combine_rowmajor(a, X, b, Y, m, n, C.memptr());
+  }
+  return C;
+}
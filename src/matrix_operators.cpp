@@ -1,4 +1,7 @@
 #include "matrix.h"
+#include "kernels.hpp"
+#include "operand.hpp"
+#include "text_buffer.hpp"
 #include <algorithm>
 #include <iomanip>
 #include <cmath>
@@ -6,35 +9,53 @@
 
 // Overloaded Accessor Operator
 // Can get a matrix element by calling matrix(1, 2)
-double& Matrix::operator()(int x, int y) {
+double& Matrix::operator()(index_t x, index_t y) {
   if (x < 0 || x >= num_rows || y < 0 || y >= num_cols) {
     throw std::out_of_range("Matrix index out of range");
   }
-  return matrix[x * num_cols + y];
+  detach();
+  return mem[offset(x, y)];
 }
 
 // Overloaded Accessor Operator (const)
 // Can get a matrix element by calling matrix(1, 2)
-const double& Matrix::operator()(int x, int y) const {
+const double& Matrix::operator()(index_t x, index_t y) const {
   if (x < 0 || x >= num_rows || y < 0 || y >= num_cols) {
     throw std::out_of_range("Matrix index out of range");
   }
-  return matrix[x * num_cols + y];
+  return mem[offset(x, y)];
 }
 
 // Overloaded Equal Operator
 bool Matrix::operator==(const Matrix& other) const {
-  if (num_rows != other.num_rows || num_cols != other.num_cols) {
+  return approx_equal(*this, other);
+}
+
+// Elementwise comparison with absolute and relative tolerance.
+// The inner loop only counts failures so it vectorizes, and the
+// early exit is checked once per block.
+bool approx_equal(const Matrix& A, const Matrix& B, double atol, double rtol) {
+  if (A.get_num_rows() != B.get_num_rows() || A.get_num_cols() != B.get_num_cols()) {
     return false;
   }
+  if (B.get_layout() != A.get_layout()) {
+    return approx_equal(A, B.to_layout(A.get_layout()), atol, rtol);
+  }
 
-  const double* m1 = this->matrix.data();
-  const double* m2 = other.matrix.data();
-
-  double epsilon = 1e-10;
-
-  for ( int i = 0; i < this->size ; i++ ) {
-    if ( std::abs(m1[i] - m2[i]) > epsilon ) return false;
+  const double* m1 = A.memptr();
+  const double* m2 = B.memptr();
+  const index_t n = A.get_size();
+  const index_t block = 4096;
+
+  for (index_t start = 0; start < n; start += block) {
+    index_t stop = std::min(n, start + block);
+    index_t failures = 0;
+    for (index_t i = start; i < stop; i++) {
+      double diff = std::abs(m1[i] - m2[i]);
+      double scale = std::max(std::abs(m1[i]), std::abs(m2[i]));
+      failures += !(diff <= atol + rtol * scale);
+    }
+    if (failures > 0) return false;
   }
 
   return true;
@@ -47,78 +68,182 @@ Matrix Matrix::operator+(const Matrix& other) const {
       throw InvalidMatrixSize("Matrix sizes must match for addition");
   }
 
-  vec result(size);
-
-  const double* m1 = this->matrix.data();
-  const double* m2 = other.matrix.data();
-  double* r = result.data();
-
-  for ( int i = 0; i < this->size ; i++ ) {
-    r[i] = m1[i] + m2[i];
-  }
-
-  return Matrix(result, num_rows, num_cols);
+  return combine(1.0, operand(*this), 1.0, operand(other), num_rows, num_cols, layout);
 }
 
 // Overloaded Subtraction Operator
 Matrix Matrix::operator-(const Matrix& other) const {
-  vec result(size);
 
-  const double* m1 = this->matrix.data();
-  const double* m2 = other.matrix.data();
-  double* r = result.data();
-
-  for ( int i = 0; i < this->size ; i++ ) {
-    r[i] = m1[i] - m2[i];
+  if (num_rows != other.num_rows || num_cols != other.num_cols) {
+      throw InvalidMatrixSize("Matrix sizes must match for subtraction");
   }
 
-  return Matrix(result, num_rows, num_cols);
+  return combine(1.0, operand(*this), -1.0, operand(other), num_rows, num_cols, layout);
 }
 
 // Overloaded Matrix-Matrix Multiplication Operator
+// Each operand is read in its own storage order (see operand.hpp) and the
+// product is stored in the layout of the left operand
 Matrix Matrix::operator*(const Matrix& other) const {
   if (this->num_cols != other.num_rows) {
       throw InvalidMatrixSize("Matrix dimensions incompatible for multiplication");
   }
-  int rows = this->num_rows;
-  int cols = other.num_cols;
-  int my_cols = this->num_cols;
+  return multiply(operand(*this), operand(other), num_rows, other.num_cols, num_cols, layout);
+}
+
+namespace {
+
+// y = A * x for a row-major rows x cols array
+// y(i) is the dot product of contiguous row i with x, so rows can be
+// handed to different threads without any combining step
+vec gemv_rows(index_t rows, index_t cols, const double* a, const vec& x) {
+  vec y(rows);
+  const double* xp = x.data();
+  double* yp = y.data();
+  std::size_t rows_per_chunk = std::max<std::size_t>(1, elementwise_grain / std::max<index_t>(cols, 1));
+
+  parallel_for(0, rows, rows_per_chunk, [&](std::size_t begin, std::size_t end) {
+    for (index_t i = begin; i < static_cast<index_t>(end); i++) {
+      yp[i] = dot_kernel(a + i * cols, xp, cols);
+    }
+  });
+  return y;
+}
+
+// y = A^T * x for a row-major rows x cols array
+// Accumulates x(i) * row i into y, which reads A with unit stride. Wide
+// matrices are split into column blocks (each thread owns part of y);
+// narrow ones into row blocks with a private y per block, summed in order.
+vec gemv_rows_transposed(index_t rows, index_t cols, const double* a, const vec& x) {
+  vec y(cols, 0.0);
+  const double* xp = x.data();
+  double* yp = y.data();
+  const index_t col_block = 512;
+
+  if (cols >= 2 * col_block) {
+    parallel_for(0, cols, col_block, [&](std::size_t begin, std::size_t end) {
+      for (index_t i = 0; i < rows; i++) {
+        axpy_kernel(xp[i], a + i * cols + begin, yp + begin, end - begin);
+      }
+    });
+    return y;
+  }
 
-  Matrix result(rows, cols);
+  std::size_t rows_per_chunk = std::max<std::size_t>(1, elementwise_grain / std::max<index_t>(cols, 1));
+  std::size_t num_chunks = (rows + rows_per_chunk - 1) / rows_per_chunk;
+  std::vector<vec> partial(num_chunks, vec(cols, 0.0));
 
-  const double* m1 = this->matrix.data();
-  const double* m2 = other.matrix.data();
-  double* r = result.matrix.data();
+  parallel_for(0, rows, rows_per_chunk, [&](std::size_t begin, std::size_t end) {
+    double* part = partial[begin / rows_per_chunk].data();
+    for (index_t i = begin; i < static_cast<index_t>(end); i++) {
+      axpy_kernel(xp[i], a + i * cols, part, cols);
+    }
+  });
+  for (const vec& part : partial) {
+    axpy_kernel(1.0, part.data(), yp, cols);
+  }
+  return y;
+}
+
+} // namespace
+
+// Matrix-Vector Multiplication (GEMV)
+// A column-major matrix is the transpose of its buffer read row-major, so
+// it takes the axpy form; either way A is read with unit stride
+vec Matrix::operator*(const vec& x) const {
+  if (static_cast<index_t>(x.size()) != num_cols) {
+      throw InvalidMatrixSize("Vector length must match matrix columns for multiplication");
+  }
+  if (layout == Layout::RowMajor) {
+    return gemv_rows(num_rows, num_cols, mem, x);
+  }
+  return gemv_rows_transposed(num_cols, num_rows, mem, x);
+}
+
+// Vector-Matrix Multiplication (x^T * A)
+vec operator*(const vec& x, const Matrix& A) {
+  const index_t rows = A.get_num_rows();
+  const index_t cols = A.get_num_cols();
+  if (static_cast<index_t>(x.size()) != rows) {
+      throw InvalidMatrixSize("Vector length must match matrix rows for multiplication");
+  }
+  if (A.get_layout() == Layout::RowMajor) {
+    return gemv_rows_transposed(rows, cols, A.memptr(), x);
+  }
+  return gemv_rows(cols, rows, A.memptr(), x);
+}
+
+// Symmetric Matrix-Vector Multiplication (SYMV), one triangle only
+// Reads the upper triangle of the buffer in row-major order, which is the
+// upper triangle of a row-major matrix and the lower one of a column-major
+// matrix. Row i of that triangle gives y(i) += A(i, i:n) . x(i:n) and
+// y(i+1:n) += x(i) * A(i, i+1:n). Rows are split into blocks of equal
+// triangle area, each block accumulating into a private y that is summed
+// in block order.
+vec Matrix::symv(const vec& x) const {
+  if (num_rows != num_cols) {
+      throw InvalidMatrixSize("symv requires a square matrix");
+  }
+  if (static_cast<index_t>(x.size()) != num_cols) {
+      throw InvalidMatrixSize("Vector length must match matrix columns for multiplication");
+  }
 
-  for (int i = 0; i < rows; ++i) {
-    for (int k = 0; k < my_cols; ++k) {
-        double a = m1[i * my_cols + k];
-        for (int j = 0; j < cols; ++j) {
-            r[i * cols + j] += a * m2[k * cols + j];
-        }
+  const index_t n = num_rows;
+  const double* a = mem;
+  const double* xp = x.data();
+
+  // number of blocks depends on n only, never on the thread count
+  double work = 0.5 * n * (n + 1.0);
+  index_t parts = static_cast<index_t>(std::min<double>(32.0, std::ceil(work / elementwise_grain)));
+  parts = std::max<index_t>(1, std::min(parts, n));
+  std::vector<index_t> splits = upper_triangle_splits(n, parts);
+  std::vector<vec> partial(parts, vec(n, 0.0));
+
+  parallel_for(0, parts, 1, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t p = begin; p < end; p++) {
+      double* part = partial[p].data();
+      for (index_t i = splits[p]; i < splits[p + 1]; i++) {
+        const double* row = a + i * n;
+        part[i] += dot_kernel(row + i, xp + i, n - i);
+        axpy_kernel(xp[i], row + i + 1, part + i + 1, n - i - 1);
+      }
     }
+  });
+
+  vec y(n, 0.0);
+  for (const vec& part : partial) {
+    axpy_kernel(1.0, part.data(), y.data(), n);
   }
-  return result;
+  return y;
 }
 
 // Overloaded Matrix-Scalar Operator
 Matrix Matrix::operator*(double s) const {
-  vec result_vec(get_size());
-
-  std::transform(matrix.begin(), matrix.end(), result_vec.begin(), 
-                  [&s](double val) { return val * s; });
-  return Matrix(result_vec, get_num_rows(), get_num_cols());
+  return map([s](double val) { return val * s; });
 }
 
+// Printing formats every value into one buffer with std::to_chars rather than
+// going through iostream formatting per element. Output is the same as
+// std::fixed, std::setprecision(4) and std::setw(8).
 std::ostream& operator<<(std::ostream& out, const Matrix & M) {
+  if (M.get_layout() != Layout::RowMajor) {
+    return out << M.to_layout(Layout::RowMajor);
+  }
   out << std::fixed << std::setprecision(4);
-  out << "\n";
-  for (int i = 0; i < M.get_num_rows(); i++) {
-      for (int j = 0; j < M.get_num_cols(); j++) {
-          out << std::setw(8) << M(i, j) << "  "; // set a constant width
+
+  const double* m = M.memptr();
+  index_t rows = M.get_num_rows();
+  index_t cols = M.get_num_cols();
+
+  TextBuffer buffer(out, static_cast<size_t>(M.get_size()) * 10 + rows + 2);
+  buffer.put('\n');
+  for (index_t i = 0; i < rows; i++) {
+      for (index_t j = 0; j < cols; j++) {
+          buffer.put_fixed(m[i * cols + j], 4, 8); // set a constant width
+          buffer.put("  ", 2);
       }
-      out << "\n"; // line between rows
+      buffer.put('\n'); // line between rows
   }
-  out << "\n";
+  buffer.put('\n');
   return out;
-}
\ No newline at end of file
+}
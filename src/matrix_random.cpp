@@ -0,0 +1,106 @@
+#include "matrix.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+// Counter-based random matrices with Philox4x32-10 (Salmon, Moraes, Dror and
+// Shaw, "Parallel random numbers: as easy as 1, 2, 3", SC 2011). A 128-bit
+// counter is encrypted with a 64-bit key in ten cheap multiply/xor rounds;
+// every output block depends only on (key, counter), so any range of
+// elements can be generated independently of the others.
+//
+// Layout of the stream: the key is the seed, counter words 2-3 hold the
+// stream and words 0-1 the block index. Block b yields elements 2b and 2b+1,
+// each built from 64 of its 128 bits.
+
+namespace {
+
+const std::uint32_t philox_m0 = 0xD2511F53;
+const std::uint32_t philox_m1 = 0xCD9E8D57;
+const std::uint32_t philox_w0 = 0x9E3779B9; // golden ratio
+const std::uint32_t philox_w1 = 0xBB67AE85; // sqrt(3) - 1
+
+// blocks encrypted together; the lane loops are unit stride and branch free,
+// so they vectorize (32 x 32 -> 64 bit multiplies)
+const int lanes = 8;
+
+// top 53 bits of a 64-bit integer to a double in [0, 1)
+inline double to_unit(std::uint32_t hi, std::uint32_t lo) {
+  std::uint64_t bits = (static_cast<std::uint64_t>(hi) << 32) | lo;
+  return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+// out[2 * (b - first_block) + {0, 1}] for blocks [first_block, first_block + lanes),
+// the two doubles of each block
+void philox_lanes(std::uint64_t first_block, std::uint64_t seed, std::uint64_t stream,
+                  double* out) {
+  std::uint32_t c0[lanes], c1[lanes], c2[lanes], c3[lanes];
+  for (int l = 0; l < lanes; l++) {
+    std::uint64_t block = first_block + l;
+    c0[l] = static_cast<std::uint32_t>(block);
+    c1[l] = static_cast<std::uint32_t>(block >> 32);
+    c2[l] = static_cast<std::uint32_t>(stream);
+    c3[l] = static_cast<std::uint32_t>(stream >> 32);
+  }
+
+  std::uint32_t k0 = static_cast<std::uint32_t>(seed);
+  std::uint32_t k1 = static_cast<std::uint32_t>(seed >> 32);
+  for (int round = 0; round < 10; round++) {
+    for (int l = 0; l < lanes; l++) {
+      std::uint64_t p0 = static_cast<std::uint64_t>(philox_m0) * c0[l];
+      std::uint64_t p1 = static_cast<std::uint64_t>(philox_m1) * c2[l];
+      std::uint32_t n0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+      std::uint32_t n2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+      c0[l] = n0;
+      c1[l] = static_cast<std::uint32_t>(p1);
+      c2[l] = n2;
+      c3[l] = static_cast<std::uint32_t>(p0);
+    }
+    k0 += philox_w0;
+    k1 += philox_w1;
+  }
+
+  for (int l = 0; l < lanes; l++) {
+    out[2 * l] = to_unit(c0[l], c1[l]);
+    out[2 * l + 1] = to_unit(c2[l], c3[l]);
+  }
+}
+
+// seed shared by the unseeded Random calls, drawn once per process
+std::uint64_t process_seed() {
+  static const std::uint64_t seed = [] {
+    std::random_device rd;
+    return (static_cast<std::uint64_t>(rd()) << 32) | rd();
+  }();
+  return seed;
+}
+
+} // namespace
+
+Matrix Matrix::Random(index_t rows, index_t cols, std::uint64_t seed, std::uint64_t stream) {
+  Matrix M(rows, cols, uninitialized);
+  double* m = M.mem;
+  const std::uint64_t n = static_cast<std::uint64_t>(M.size);
+  const std::uint64_t per_batch = 2 * lanes;
+  const std::uint64_t batches = (n + per_batch - 1) / per_batch;
+
+  // chunk boundaries only decide who computes a batch, not its values
+  parallel_for(0, batches, elementwise_grain / per_batch, [&](std::size_t first, std::size_t last) {
+    double buffer[2 * lanes];
+    for (std::size_t batch = first; batch < last; batch++) {
+      std::uint64_t begin = batch * per_batch;
+      if (begin + per_batch <= n) {
+        philox_lanes(batch * lanes, seed, stream, m + begin);
+      } else {
+        philox_lanes(batch * lanes, seed, stream, buffer);
+        std::copy(buffer, buffer + (n - begin), m + begin);
+      }
+    }
+  });
+  return M;
+}
+
+Matrix Matrix::Random(index_t rows, index_t cols) {
+  static std::atomic<std::uint64_t> next_stream{0};
+  return Random(rows, cols, process_seed(), next_stream++);
+}
@@ -0,0 +1,175 @@
+#include "matrix.h"
+#include "kernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Chunk kernels for the built-in reductions. Each keeps four independent
+// accumulators so the compiler can vectorize without reassociating a single
+// running sum, and the partial sums are always combined in the same order.
+namespace {
+
+double chunk_sum(const double* x, std::size_t n) {
+  double acc[4] = {0.0, 0.0, 0.0, 0.0};
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc[0] += x[i];
+    acc[1] += x[i + 1];
+    acc[2] += x[i + 2];
+    acc[3] += x[i + 3];
+  }
+  for (; i < n; i++) acc[0] += x[i];
+  return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+double chunk_sum_sq_diff(const double* x, const double* y, std::size_t n) {
+  double acc[4] = {0.0, 0.0, 0.0, 0.0};
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    double d0 = x[i] - y[i], d1 = x[i + 1] - y[i + 1];
+    double d2 = x[i + 2] - y[i + 2], d3 = x[i + 3] - y[i + 3];
+    acc[0] += d0 * d0;
+    acc[1] += d1 * d1;
+    acc[2] += d2 * d2;
+    acc[3] += d3 * d3;
+  }
+  for (; i < n; i++) acc[0] += (x[i] - y[i]) * (x[i] - y[i]);
+  return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+// std::max(acc, x) keeps acc when x is NaN; this keeps the NaN, in either
+// argument, so a NaN anywhere makes max_abs() NaN
+inline double max_nan(double acc, double x) {
+  return acc > x || acc != acc ? acc : x;
+}
+
+double chunk_max_abs(const double* x, std::size_t n) {
+  double acc[4] = {0.0, 0.0, 0.0, 0.0};
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc[0] = max_nan(acc[0], std::abs(x[i]));
+    acc[1] = max_nan(acc[1], std::abs(x[i + 1]));
+    acc[2] = max_nan(acc[2], std::abs(x[i + 2]));
+    acc[3] = max_nan(acc[3], std::abs(x[i + 3]));
+  }
+  for (; i < n; i++) acc[0] = max_nan(acc[0], std::abs(x[i]));
+  return max_nan(max_nan(acc[0], acc[1]), max_nan(acc[2], acc[3]));
+}
+
+void check_same_shape(const Matrix& A, const Matrix& B) {
+  if (A.get_num_rows() != B.get_num_rows() || A.get_num_cols() != B.get_num_cols()) {
+    throw InvalidMatrixSize("Matrix sizes must match for elementwise operations");
+  }
+}
+
+double flat_dot(const double* a, const double* b, std::size_t n) {
+  return parallel_reduce(0, n, elementwise_grain, 0.0,
+    [&](std::size_t first, std::size_t last) { return dot_kernel(a + first, b + first, last - first); },
+    [](double x, double y) { return x + y; });
+}
+
+// trace(A*B) = sum_i sum_k A(i,k) * B(k,i) for row-major A (m x n), B (n x m)
+// B is read column-wise, so both operands are walked in square tiles that
+// stay in cache; chunks are blocks of rows of A.
+double trace_prod_rowmajor(index_t m, index_t n, const double* a, const double* b) {
+  const index_t tile = 64;
+  // rows per chunk chosen so every chunk is about elementwise_grain products
+  std::size_t rows_per_chunk = std::max<std::size_t>(tile, elementwise_grain / std::max<index_t>(n, 1));
+
+  return parallel_reduce(0, m, rows_per_chunk, 0.0,
+    [&](std::size_t first, std::size_t last) {
+      double acc = 0.0;
+      for (index_t i0 = first; i0 < static_cast<index_t>(last); i0 += tile) {
+        index_t i1 = std::min(static_cast<index_t>(last), i0 + tile);
+        for (index_t k0 = 0; k0 < n; k0 += tile) {
+          index_t k1 = std::min(n, k0 + tile);
+          for (index_t i = i0; i < i1; i++) {
+            const double* a_row = a + i * n;
+            for (index_t k = k0; k < k1; k++) {
+              acc += a_row[k] * b[k * m + i];
+            }
+          }
+        }
+      }
+      return acc;
+    },
+    [](double x, double y) { return x + y; });
+}
+
+} // namespace
+
+double Matrix::sum() const {
+  const double* m = mem;
+  return parallel_reduce(0, size, elementwise_grain, 0.0,
+    [&](std::size_t b, std::size_t e) { return chunk_sum(m + b, e - b); },
+    [](double x, double y) { return x + y; });
+}
+
+double Matrix::norm_fro() const {
+  const double* m = mem;
+  return std::sqrt(parallel_reduce(0, size, elementwise_grain, 0.0,
+    [&](std::size_t b, std::size_t e) { return dot_kernel(m + b, m + b, e - b); },
+    [](double x, double y) { return x + y; }));
+}
+
+double Matrix::max_abs() const {
+  const double* m = mem;
+  return parallel_reduce(0, size, elementwise_grain, 0.0,
+    [&](std::size_t b, std::size_t e) { return chunk_max_abs(m + b, e - b); },
+    [](double x, double y) { return max_nan(x, y); });
+}
+
+// Sum of the main diagonal (of the leading square block for non-square matrices)
+double Matrix::trace() const {
+  double t = 0.0;
+  index_t n = std::min(num_rows, num_cols);
+  for (index_t i = 0; i < n; i++) {
+    t += mem[offset(i, i)];
+  }
+  return t;
+}
+
+// With different layouts one buffer holds the transpose of the other's
+// shape, which is exactly the access pattern of trace_prod
+double dot(const Matrix& A, const Matrix& B) {
+  check_same_shape(A, B);
+  if (A.get_layout() == B.get_layout()) {
+    return flat_dot(A.memptr(), B.memptr(), A.get_size());
+  }
+  const Matrix& R = A.get_layout() == Layout::RowMajor ? A : B;
+  const Matrix& C = A.get_layout() == Layout::RowMajor ? B : A;
+  return trace_prod_rowmajor(R.get_num_rows(), R.get_num_cols(), R.memptr(), C.memptr());
+}
+
+double rms_diff(const Matrix& A, const Matrix& B) {
+  check_same_shape(A, B);
+  if (A.get_size() == 0) {
+    return 0.0;
+  }
+  if (A.get_layout() != B.get_layout()) {
+    return rms_diff(A, B.to_layout(A.get_layout()));
+  }
+  const double* a = A.memptr();
+  const double* b = B.memptr();
+  double sq = parallel_reduce(0, A.get_size(), elementwise_grain, 0.0,
+    [&](std::size_t first, std::size_t last) { return chunk_sum_sq_diff(a + first, b + first, last - first); },
+    [](double x, double y) { return x + y; });
+  return std::sqrt(sq / A.get_size());
+}
+
+// trace(A*B) for every layout combination: two row-major operands use the
+// tiled kernel, two column-major ones the same kernel on trace(B^T A^T), and
+// mixed layouts reduce to a flat dot product of the two buffers
+double trace_prod(const Matrix& A, const Matrix& B) {
+  index_t m = A.get_num_rows();
+  index_t n = A.get_num_cols();
+  if (B.get_num_rows() != n || B.get_num_cols() != m) {
+    throw InvalidMatrixSize("trace_prod requires A (m x n) and B (n x m)");
+  }
+  if (A.get_layout() != B.get_layout()) {
+    return flat_dot(A.memptr(), B.memptr(), A.get_size());
+  }
+  if (A.get_layout() == Layout::RowMajor) {
+    return trace_prod_rowmajor(m, n, A.memptr(), B.memptr());
+  }
+  return trace_prod_rowmajor(m, n, B.memptr(), A.memptr());
+}
@@ -0,0 +1,142 @@
+#include "matrix.h"
+#include "kernels.hpp"
+#include "operand.hpp"
+#include <algorithm>
+
+// Lazy transpose: the view keeps a reference to the original matrix and the
+// operators below read it through transposed-operand kernels
+
+TransposeView::TransposeView(const Matrix& parent) : m(parent) {}
+
+// -------------------------------------------------------------------
+// Accessors
+// -------------------------------------------------------------------
+index_t TransposeView::get_num_rows() const
+{
+  return m.get_num_cols();
+}
+
+index_t TransposeView::get_num_cols() const
+{
+  return m.get_num_rows();
+}
+
+index_t TransposeView::get_size() const
+{
+  return m.get_size();
+}
+
+const Matrix& TransposeView::parent() const
+{
+  return m;
+}
+
+const double& TransposeView::operator()(index_t x, index_t y) const {
+  return m(y, x);
+}
+
+const Matrix& TransposeView::t() const {
+  return m;
+}
+
+// -------------------------------------------------------------------
+// Materialization
+// -------------------------------------------------------------------
+
+// The result is row-major. The transpose of a column-major matrix has the
+// same buffer, so that case is a plain copy.
+Matrix TransposeView::eval() const {
+  index_t rows = get_num_rows();
+  index_t cols = get_num_cols();
+  const double* buffer = m.memptr();
+  Matrix result(rows, cols, Matrix::uninitialized);
+  if (m.get_layout() == Layout::ColMajor) {
+    std::copy(buffer, buffer + m.get_size(), result.memptr());
+  } else {
+    transpose_kernel(rows, cols, buffer, result.memptr());
+  }
+  return result;
+}
+
+TransposeView::operator Matrix() const {
+  return eval();
+}
+
+// -------------------------------------------------------------------
+// Products, sums and differences
+// Every operand goes through operand() (see operand.hpp); results with a
+// view on the left are row-major, otherwise they take the left layout.
+// -------------------------------------------------------------------
+namespace {
+void check_product(index_t inner_left, index_t inner_right) {
+  if (inner_left != inner_right) {
+    throw InvalidMatrixSize("Matrix dimensions incompatible for multiplication");
+  }
+}
+
+template <typename L, typename R>
+void check_sum(const L& A, const R& B) {
+  if (A.get_num_rows() != B.get_num_rows() || A.get_num_cols() != B.get_num_cols()) {
+    throw InvalidMatrixSize("Matrix sizes must match for addition");
+  }
+}
+}
+
+// A^T * B
+Matrix operator*(const TransposeView& At, const Matrix& B) {
+  check_product(At.get_num_cols(), B.get_num_rows());
+  return multiply(operand(At), operand(B), At.get_num_rows(), B.get_num_cols(),
+                  At.get_num_cols(), Layout::RowMajor);
+}
+
+// A * B^T
+Matrix operator*(const Matrix& A, const TransposeView& Bt) {
+  check_product(A.get_num_cols(), Bt.get_num_rows());
+  return multiply(operand(A), operand(Bt), A.get_num_rows(), Bt.get_num_cols(),
+                  A.get_num_cols(), A.get_layout());
+}
+
+// A^T * B^T
+Matrix operator*(const TransposeView& At, const TransposeView& Bt) {
+  check_product(At.get_num_cols(), Bt.get_num_rows());
+  return multiply(operand(At), operand(Bt), At.get_num_rows(), Bt.get_num_cols(),
+                  At.get_num_cols(), Layout::RowMajor);
+}
+
+vec operator*(const TransposeView& At, const vec& x) {
+  return x * At.parent();
+}
+
+vec operator*(const vec& x, const TransposeView& At) {
+  return At.parent() * x;
+}
+
+Matrix operator+(const Matrix& A, const TransposeView& Bt) {
+  check_sum(A, Bt);
+  return combine(1.0, operand(A), 1.0, operand(Bt), A.get_num_rows(), A.get_num_cols(), A.get_layout());
+}
+
+Matrix operator+(const TransposeView& At, const Matrix& B) {
+  check_sum(At, B);
+  return combine(1.0, operand(At), 1.0, operand(B), B.get_num_rows(), B.get_num_cols(), Layout::RowMajor);
+}
+
+Matrix operator-(const Matrix& A, const TransposeView& Bt) {
+  check_sum(A, Bt);
+  return combine(1.0, operand(A), -1.0, operand(Bt), A.get_num_rows(), A.get_num_cols(), A.get_layout());
+}
+
+Matrix operator-(const TransposeView& At, const Matrix& B) {
+  check_sum(At, B);
+  return combine(1.0, operand(At), -1.0, operand(B), B.get_num_rows(), B.get_num_cols(), Layout::RowMajor);
+}
+
+Matrix operator+(const TransposeView& At, const TransposeView& Bt) {
+  check_sum(At, Bt);
+  return combine(1.0, operand(At), 1.0, operand(Bt), At.get_num_rows(), At.get_num_cols(), Layout::RowMajor);
+}
+
+Matrix operator-(const TransposeView& At, const TransposeView& Bt) {
+  check_sum(At, Bt);
+  return combine(1.0, operand(At), -1.0, operand(Bt), At.get_num_rows(), At.get_num_cols(), Layout::RowMajor);
+}
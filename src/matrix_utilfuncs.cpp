@@ -1,22 +1,20 @@
 #include "matrix.h"
+#include <algorithm>
 #include <cmath>
 #include <highfive/H5File.hpp>
 
 // Build diagonal matrix from a vector
-// Result is an n x n matrix with vector[i] on the diagonal
-Matrix Matrix::diagmat(const vec& vector) {
-  Matrix result = Matrix::Zeros(vector.size(), vector.size());
-  for (int i = 0; i < vector.size(); i++ ) {
-    result(i, i) = vector[i];
-  }
-  return result;
+// Result is an n x n diagonal matrix with vector[i] on the diagonal,
+// storing only the n values
+DiagonalMatrix Matrix::diagmat(const vec& vector) {
+  return DiagonalMatrix(vector);
 }
 
 // Build diagonal matrix by extracting the diagonal of input matrix
 // Result is same shape as input but with only diagonal entries remaining
 Matrix Matrix::diagmat(const Matrix& mat) {
   Matrix result = Matrix::Zeros(mat.get_num_rows(), mat.get_num_cols());
-  for (int i = 0; i < std::min(mat.get_num_rows(), mat.get_num_cols()); i++) {
+  for (index_t i = 0; i < std::min(mat.get_num_rows(), mat.get_num_cols()); i++) {
     result(i, i) = mat(i, i);
   }
   return result;
@@ -24,93 +22,99 @@ Matrix Matrix::diagmat(const Matrix& mat) {
 
 // Check if matrix is symmetric within tolerance tol
 // Not symmetric if matrix is not square
-bool Matrix::is_symmetric(double tol = 1e-12) const {
+//
+// The upper triangle is walked in square tiles. The partner tile below the
+// diagonal is first copied transposed into a small buffer (reading its rows
+// contiguously), so the comparison itself runs over two unit-stride arrays.
+// Failures are counted per tile, which keeps the inner loop branch free.
+// The buffer is checked as stored: a matrix is symmetric in either layout
+// exactly when its transpose is.
+bool Matrix::is_symmetric(double tol) const {
   if (num_rows != num_cols)
       return false;
 
-  for (int i = 0; i < num_rows; i++) {
-      for (int j = i + 1; j < num_cols; j++) {  
-          if (std::abs((*this)(i, j) - (*this)(j, i)) > tol)
-              return false;
+  const index_t n = num_rows;
+  const index_t tile = 32;
+  const double* m = mem;
+  double partner[tile * tile];
+
+  for (index_t i0 = 0; i0 < n; i0 += tile) {
+    index_t i1 = std::min(n, i0 + tile);
+
+    for (index_t j0 = i0; j0 < n; j0 += tile) {
+      index_t j1 = std::min(n, j0 + tile);
+      index_t w = j1 - j0;
+
+      // partner[(i - i0) * tile + (j - j0)] = A(j, i)
+      for (index_t j = j0; j < j1; j++) {
+        for (index_t i = i0; i < i1; i++) {
+          partner[(i - i0) * tile + (j - j0)] = m[j * n + i];
+        }
+      }
+
+      index_t failures = 0;
+      for (index_t i = i0; i < i1; i++) {
+        const double* row = m + i * n + j0;
+        const double* other = partner + (i - i0) * tile;
+        // on diagonal tiles only the part right of the diagonal matters
+        index_t start = (j0 == i0) ? (i - i0 + 1) : 0;
+        for (index_t k = start; k < w; k++) {
+          failures += !(std::abs(row[k] - other[k]) <= tol);
+        }
       }
+      if (failures > 0)
+          return false;
+    }
   }
   return true;
 }
 
-// Transpose matrix
+// Transpose matrix, a tiled copy of the lazy view
 Matrix Matrix::transpose() const {
-  Matrix result(num_cols, num_rows);
-
-  for (int i = 0; i < num_rows; i++) {
-      for (int j = 0; j < num_cols; j++) {
-          result(j, i) = (*this)(i, j);
-      }
-  }
+  return t().eval();
+}
 
-  return result;
+TransposeView Matrix::t() const {
+  return TransposeView(*this);
 }
 
 // Save Matrix to HDF5 file (dataset_name) using HighFive
-// Because Matrix stores elements as a flat vector, we reshape into a 2D
-// container before writing
+// The row-major buffer is written as a rows x cols dataset in one call, with
+// 64-bit HDF5 dimensions; a column-major matrix is converted first
 void Matrix::save_hdf5(const Matrix& data, 
                         const std::string& filename,
                        const std::string& dataset_name)
 {
-  int rows = data.get_num_rows();
-  int cols = data.get_num_cols();
+  if (data.get_layout() != Layout::RowMajor) {
+    save_hdf5(data.to_layout(Layout::RowMajor), filename, dataset_name);
+    return;
+  }
 
   // get file, might need to create it
   HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create);
 
-  // need to use hsize_t type from HDF5
-  std::vector<hsize_t> dimensions = { 
-      static_cast<hsize_t>(rows),
-      static_cast<hsize_t>(cols)
-  };
-
-  // Convert flat to 2D
-  std::vector<vec> reshaped(rows, vec(cols));
-    const vec& flat = data.get_data();
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            reshaped[i][j] = flat[i * cols + j];
-        }
-    }
-
-  // Create dataset
+  // Create dataset, need to use hsize_t type from HDF5
   HighFive::DataSet dataset = file.createDataSet<double>(
       dataset_name,
-      HighFive::DataSpace({static_cast<hsize_t>(rows),
-                           static_cast<hsize_t>(cols)}));
+      HighFive::DataSpace({static_cast<hsize_t>(data.get_num_rows()),
+                           static_cast<hsize_t>(data.get_num_cols())}));
 
-    // add matrix data to the dataset
-  dataset.write(reshaped);
+  // add matrix data to the dataset
+  dataset.write_raw(data.memptr());
 }
 
 void Matrix::save_hdf5(const vec& data, 
                         const std::string& filename,
                         const std::string& dataset_name)
 {
-  size_t size = data.size();
   // get file, might need to create it
   HighFive::File file(filename, HighFive::File::ReadWrite | HighFive::File::Create);
 
-  // need to use hsize_t type from HDF5
-  std::vector<hsize_t> dimensions = {
-    static_cast<hsize_t>(size)
-    };
-
-  // need to convert to column vector
-  std::vector<vec> column_vec(size, vec(1));
-  for (size_t i = 0; i < size; i++) {
-      column_vec[i][0] = data[i];
-  }
-
+  // written as a column vector
   HighFive::DataSet dataset = file.createDataSet<double>(
-      dataset_name, HighFive::DataSpace({size, 1})
+      dataset_name, HighFive::DataSpace({static_cast<hsize_t>(data.size()), 1})
   );
 
   // add vec data to the dataset
-  dataset.write(column_vec);
-}
\ No newline at end of file
+  dataset.write_raw(data.data());
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "matrix.h"
+
+// Layout dispatch for the binary kernels. Every operand is described in
+// row-major terms: a row-major array, read transposed when `trans` is set.
+// A column-major m x n matrix is exactly the transpose of its buffer read as
+// a row-major n x m array, and a TransposeView flips its parent's flag, so
+// each combination of layouts and views maps onto the N/T kernel variants.
+
+struct Operand {
+  const double* data;
+  bool trans;
+};
+
+inline Operand operand(const Matrix& M) {
+  return {M.memptr(), M.get_layout() == Layout::ColMajor};
+}
+
+inline Operand operand(const TransposeView& V) {
+  return {V.parent().memptr(), V.parent().get_layout() == Layout::RowMajor};
+}
+
+/**
+ * @brief op(A) * op(B) with op(A) m x k and op(B) k x n, stored in `layout`
+ *
+ * A column-major result is computed as the row-major C^T = op(B)^T op(A)^T,
+ * so it costs the same as a row-major one.
+ */
+Matrix multiply(Operand A, Operand B, index_t m, index_t n, index_t k, Layout layout);
+
+/**
+ * @brief a * op(X) + b * op(Y) for m x n operands, stored in `layout`
+ */
+Matrix combine(double a, Operand X, double b, Operand Y, index_t m, index_t n, Layout layout);
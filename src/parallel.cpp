@@ -0,0 +1,180 @@
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// set while a thread is running chunks, nested parallel_for calls then run inline
+thread_local bool inside_parallel = false;
+
+int default_num_threads() {
+  if (const char* env = std::getenv("MATRIXLIBRARY_NUM_THREADS")) {
+    int n = std::atoi(env);
+    if (n > 0) return n;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/*
+ Persistent pool of worker threads. One job runs at a time: the submitting
+ thread publishes it, wakes the workers and everyone pulls chunk indices from
+ an atomic counter until the range is exhausted.
+*/
+class ThreadPool {
+private:
+  std::vector<std::thread> workers;
+  int num_threads;
+
+  std::mutex submit_mutex; // held for the duration of a job
+  std::mutex state_mutex;
+  std::condition_variable work_ready;
+  std::condition_variable work_done;
+
+  // current job, only written while all workers are idle
+  const std::function<void(std::size_t, std::size_t)>* body = nullptr;
+  std::size_t job_begin = 0, job_end = 0, job_grain = 1, job_chunks = 0;
+  std::atomic<std::size_t> next_chunk{0};
+  std::exception_ptr error;
+
+  unsigned long generation = 0;
+  int busy_workers = 0;
+  bool stopping = false;
+
+  void run_chunks() {
+    inside_parallel = true;
+    std::size_t c;
+    while ((c = next_chunk.fetch_add(1)) < job_chunks) {
+      std::size_t b = job_begin + c * job_grain;
+      std::size_t e = std::min(job_end, b + job_grain);
+      try {
+        (*body)(b, e);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        if (!error) error = std::current_exception();
+        next_chunk = job_chunks; // stop handing out work
+      }
+    }
+    inside_parallel = false;
+  }
+
+  // seen is the last generation this worker took part in
+  void worker_loop(unsigned long seen) {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(state_mutex);
+        work_ready.wait(lock, [&] { return stopping || generation != seen; });
+        if (stopping) return;
+        seen = generation;
+      }
+
+      run_chunks();
+
+      std::lock_guard<std::mutex> lock(state_mutex);
+      if (--busy_workers == 0) work_done.notify_one();
+    }
+  }
+
+  void start(int n) {
+    num_threads = n;
+    stopping = false;
+    for (int i = 1; i < n; i++) {
+      workers.emplace_back([this, g = generation] { worker_loop(g); });
+    }
+  }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(state_mutex);
+      stopping = true;
+    }
+    work_ready.notify_all();
+    for (std::thread& t : workers) t.join();
+    workers.clear();
+  }
+
+public:
+  ThreadPool() { start(default_num_threads()); }
+  ~ThreadPool() { stop(); }
+
+  int size() const { return num_threads; }
+
+  void resize(int n) {
+    std::lock_guard<std::mutex> submit(submit_mutex);
+    stop();
+    start(n);
+  }
+
+  void run(std::size_t begin, std::size_t end, std::size_t grain,
+           const std::function<void(std::size_t, std::size_t)>& f) {
+    std::size_t chunks = (end - begin + grain - 1) / grain;
+
+    // another thread owns the pool: do the work here rather than wait for it
+    std::unique_lock<std::mutex> submit(submit_mutex, std::try_to_lock);
+    if (!submit.owns_lock() || workers.empty()) {
+      bool was_inside = inside_parallel;
+      inside_parallel = true;
+      try {
+        for (std::size_t b = begin; b < end; b += grain) f(b, std::min(end, b + grain));
+      } catch (...) {
+        inside_parallel = was_inside;
+        throw;
+      }
+      inside_parallel = was_inside;
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(state_mutex);
+      body = &f;
+      job_begin = begin;
+      job_end = end;
+      job_grain = grain;
+      job_chunks = chunks;
+      next_chunk = 0;
+      error = nullptr;
+      busy_workers = static_cast<int>(workers.size());
+      generation++;
+    }
+    work_ready.notify_all();
+
+    run_chunks();
+
+    std::unique_lock<std::mutex> lock(state_mutex);
+    work_done.wait(lock, [&] { return busy_workers == 0; });
+    body = nullptr;
+    if (error) std::rethrow_exception(error);
+  }
+};
+
+ThreadPool& pool() {
+  static ThreadPool instance;
+  return instance;
+}
+
+} // namespace
+
+int get_num_threads() {
+  return pool().size();
+}
+
+void set_num_threads(int n) {
+  pool().resize(n > 0 ? n : default_num_threads());
+}
+
+void parallel_for_chunks(std::size_t begin, std::size_t end, std::size_t grain,
+                         const std::function<void(std::size_t, std::size_t)>& body) {
+  if (end <= begin) return;
+  if (grain == 0) grain = 1;
+
+  // single chunk or nested call: no point waking the workers
+  if (end - begin <= grain || inside_parallel) {
+    for (std::size_t b = begin; b < end; b += grain) body(b, std::min(end, b + grain));
+    return;
+  }
+  pool().run(begin, end, grain, body);
+}
@@ -0,0 +1,164 @@
+#include "purification.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// below this the idempotency error is set by rounding (or truncation) once
+// it stops decreasing. A single step may double the error of the eigenvalues
+// on the side it does not square, so progress is judged over two steps, as
+// in Kruchinina et al., J. Chem. Phys. 144, 244113 (2016)
+constexpr double purify_plateau = 1e-4;
+
+// Gershgorin interval containing the spectrum of a symmetric matrix
+std::pair<double, double> spectral_bounds(const Matrix& F) {
+  index_t n = F.get_num_rows();
+  double lo = std::numeric_limits<double>::infinity();
+  double hi = -lo;
+  for (index_t i = 0; i < n; i++) {
+    double radius = 0.0;
+    for (index_t j = 0; j < n; j++) {
+      if (j != i) radius += std::abs(F(i, j));
+    }
+    lo = std::min(lo, F(i, i) - radius);
+    hi = std::max(hi, F(i, i) + radius);
+  }
+  return {lo, hi};
+}
+
+std::pair<double, double> spectral_bounds(const SparseMatrix& F) {
+  const std::vector<index_t>& row_ptr = F.get_row_ptr();
+  const std::vector<index_t>& col_idx = F.get_col_idx();
+  const vec& values = F.get_values();
+  double lo = std::numeric_limits<double>::infinity();
+  double hi = -lo;
+  for (index_t i = 0; i < F.get_num_rows(); i++) {
+    double diag = 0.0;
+    double radius = 0.0;
+    for (index_t p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+      if (col_idx[p] == i) {
+        diag = values[p];
+      } else {
+        radius += std::abs(values[p]);
+      }
+    }
+    lo = std::min(lo, diag - radius);
+    hi = std::max(hi, diag + radius);
+  }
+  return {lo, hi};
+}
+
+// X0 = (hi I - F) / (hi - lo)
+Matrix initial_guess(const Matrix& F, double lo, double hi) {
+  double s = 1.0 / (hi - lo);
+  Matrix X = F * -s;
+  for (index_t i = 0; i < F.get_num_rows(); i++) {
+    X(i, i) += hi * s;
+  }
+  return X;
+}
+
+SparseMatrix initial_guess(const SparseMatrix& F, double lo, double hi) {
+  double s = 1.0 / (hi - lo);
+  return F * -s + SparseMatrix::Identity(F.get_num_rows()) * (hi * s);
+}
+
+Matrix square(const Matrix& X, const PurificationOptions&) {
+  return X * X;
+}
+
+SparseMatrix square(const SparseMatrix& X, const PurificationOptions& options) {
+  return X.multiply(X, options.drop_tol);
+}
+
+// 2X - X^2
+Matrix reflect(const Matrix& X, const Matrix& X2, const PurificationOptions&) {
+  return X * 2.0 - X2;
+}
+
+SparseMatrix reflect(const SparseMatrix& X, const SparseMatrix& X2, const PurificationOptions& options) {
+  return (X * 2.0 - X2).prune(options.drop_tol);
+}
+
+double trace_of(const Matrix& X) {
+  return X.trace();
+}
+
+double trace_of(const SparseMatrix& X) {
+  double sum = 0.0;
+  for (double d : X.diagonal()) {
+    sum += d;
+  }
+  return sum;
+}
+
+template <typename MatrixType>
+PurificationResult<MatrixType> tc2(const MatrixType& F, index_t num_occupied,
+                                   const PurificationOptions& options) {
+  index_t n = F.get_num_rows();
+  if (n != F.get_num_cols()) {
+    throw InvalidMatrixSize("purify_density requires a square matrix");
+  }
+  if (num_occupied < 0 || num_occupied > n) {
+    throw InvalidMatrixSize("purify_density: num_occupied must be between 0 and n");
+  }
+  if (!F.is_symmetric(1e-8)) {
+    throw InvalidMatrixSize("Matrix must be symmetric for purify_density()");
+  }
+
+  auto [lo, hi] = spectral_bounds(F);
+  if (!(hi - lo > std::numeric_limits<double>::min())) {
+    // F is a multiple of I; widen the interval so that X0 = I / 2
+    lo -= 1.0;
+    hi += 1.0;
+  }
+  MatrixType X = initial_guess(F, lo, hi);
+  double occupied = static_cast<double>(num_occupied);
+
+  double errors[2] = {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+  for (int iter = 0; iter <= options.max_iterations; iter++) {
+    MatrixType X2 = square(X, options);
+    double error = (X2 - X).norm_fro();
+    if (error <= options.tol || (error < purify_plateau && error >= errors[0])) {
+      if (std::abs(trace_of(X) - occupied) > 0.5) {
+        throw std::runtime_error("purify_density: trace does not match num_occupied; "
+                                 "there is no gap at the Fermi level");
+      }
+      PurificationResult<MatrixType> result;
+      result.density = std::move(X);
+      result.iterations = iter;
+      result.idempotency_error = error;
+      return result;
+    }
+    if (iter == options.max_iterations) {
+      break;
+    }
+    errors[0] = errors[1];
+    errors[1] = error;
+
+    // X^2 lowers the trace and 2X - X^2 raises it; take the one that ends
+    // closer to num_occupied
+    double t = trace_of(X);
+    double t2 = trace_of(X2);
+    if (std::abs(t2 - occupied) < std::abs(2.0 * t - t2 - occupied)) {
+      X = std::move(X2);
+    } else {
+      X = reflect(X, X2, options);
+    }
+  }
+  throw std::runtime_error("purify_density: no convergence within max_iterations");
+}
+
+} // namespace
+
+PurificationResult<Matrix> purify_density(const Matrix& F, index_t num_occupied,
+                                          const PurificationOptions& options) {
+  return tc2(F, num_occupied, options);
+}
+
+PurificationResult<SparseMatrix> purify_density(const SparseMatrix& F, index_t num_occupied,
+                                                const PurificationOptions& options) {
+  return tc2(F, num_occupied, options);
+}
@@ -0,0 +1,448 @@
+#include "sparse_matrix.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// rows per parallel chunk so that a chunk does about elementwise_grain units
+// of work, given the total over all rows
+std::size_t rows_per_chunk(index_t rows, double work) {
+  if (rows <= 0) {
+    return 1;
+  }
+  double per_row = std::max(work / static_cast<double>(rows), 1.0);
+  return std::max<std::size_t>(1, static_cast<std::size_t>(elementwise_grain / per_row));
+}
+
+} // namespace
+
+// -------------------------------------------------------------------
+// Parallel construction
+// -------------------------------------------------------------------
+
+// fill(begin, end, cols, vals, row_end) appends the entries of rows
+// [begin, end) to cols / vals, columns ascending, and stores cols.size()
+// after row i in row_end[i]. Each chunk of rows fills its own buffers, which
+// are then concatenated in chunk order.
+template <typename ChunkF>
+SparseMatrix SparseMatrix::build_rows(index_t rows, index_t cols, std::size_t chunk_rows, ChunkF fill) {
+  SparseMatrix result(rows, cols);
+  if (rows == 0) {
+    return result;
+  }
+  std::size_t num_chunks = (static_cast<std::size_t>(rows) + chunk_rows - 1) / chunk_rows;
+  std::vector<std::vector<index_t>> chunk_cols(num_chunks);
+  std::vector<vec> chunk_vals(num_chunks);
+  std::vector<index_t>& ptr = result.row_ptr;
+
+  parallel_for(0, rows, chunk_rows, [&](std::size_t b, std::size_t e) {
+    std::size_t c = b / chunk_rows;
+    fill(static_cast<index_t>(b), static_cast<index_t>(e), chunk_cols[c], chunk_vals[c], ptr.data() + 1);
+  });
+
+  // chunk-local row ends to global offsets
+  std::vector<index_t> offsets(num_chunks + 1, 0);
+  for (std::size_t c = 0; c < num_chunks; c++) {
+    offsets[c + 1] = offsets[c] + static_cast<index_t>(chunk_cols[c].size());
+    index_t end = std::min<index_t>(rows, static_cast<index_t>((c + 1) * chunk_rows));
+    for (index_t i = static_cast<index_t>(c * chunk_rows); i < end; i++) {
+      ptr[i + 1] += offsets[c];
+    }
+  }
+
+  result.col_idx.resize(offsets[num_chunks]);
+  result.values.resize(offsets[num_chunks]);
+  parallel_for(0, num_chunks, 1, [&](std::size_t b, std::size_t e) {
+    for (std::size_t c = b; c < e; c++) {
+      std::copy(chunk_cols[c].begin(), chunk_cols[c].end(), result.col_idx.begin() + offsets[c]);
+      std::copy(chunk_vals[c].begin(), chunk_vals[c].end(), result.values.begin() + offsets[c]);
+    }
+  });
+  return result;
+}
+
+// -------------------------------------------------------------------
+// Constructors
+// -------------------------------------------------------------------
+SparseMatrix::SparseMatrix(index_t rows, index_t cols)
+    : num_rows(rows), num_cols(cols), row_ptr(rows + 1, 0) {
+  if (rows < 0 || cols < 0) {
+    throw InvalidMatrixSize("Matrix dimensions must be non-negative");
+  }
+}
+
+SparseMatrix::SparseMatrix(index_t rows, index_t cols, std::vector<index_t> row_ptr_,
+                           std::vector<index_t> col_idx_, vec values_)
+    : num_rows(rows), num_cols(cols), row_ptr(std::move(row_ptr_)),
+      col_idx(std::move(col_idx_)), values(std::move(values_)) {
+  if (rows < 0 || cols < 0) {
+    throw InvalidMatrixSize("Matrix dimensions must be non-negative");
+  }
+  if (static_cast<index_t>(row_ptr.size()) != rows + 1 || col_idx.size() != values.size() ||
+      row_ptr.front() != 0 || row_ptr.back() != static_cast<index_t>(col_idx.size())) {
+    throw InvalidMatrixSize("SparseMatrix: CSR arrays do not fit the matrix shape");
+  }
+  for (index_t i = 0; i < rows; i++) {
+    if (row_ptr[i + 1] < row_ptr[i]) {
+      throw std::invalid_argument("SparseMatrix: row_ptr must be non-decreasing");
+    }
+    for (index_t p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+      if (col_idx[p] < 0 || col_idx[p] >= cols) {
+        throw std::out_of_range("SparseMatrix: column index out of range");
+      }
+      if (p > row_ptr[i] && col_idx[p] <= col_idx[p - 1]) {
+        throw std::invalid_argument("SparseMatrix: columns must be strictly ascending within a row");
+      }
+    }
+  }
+}
+
+SparseMatrix SparseMatrix::from_dense(const Matrix& A, double drop_tol) {
+  index_t rows = A.get_num_rows();
+  index_t cols = A.get_num_cols();
+  const double* a = A.memptr();
+  // stride between consecutive elements of a row, and between rows
+  index_t col_step = A.get_layout() == Layout::RowMajor ? 1 : rows;
+  index_t row_step = A.get_layout() == Layout::RowMajor ? cols : 1;
+
+  return build_rows(rows, cols, rows_per_chunk(rows, static_cast<double>(rows) * cols),
+                    [&](index_t begin, index_t end, std::vector<index_t>& c, vec& v, index_t* row_end) {
+    for (index_t i = begin; i < end; i++) {
+      const double* row = a + i * row_step;
+      for (index_t j = 0; j < cols; j++) {
+        double x = row[j * col_step];
+        if (std::abs(x) > drop_tol) {
+          c.push_back(j);
+          v.push_back(x);
+        }
+      }
+      row_end[i] = static_cast<index_t>(c.size());
+    }
+  });
+}
+
+SparseMatrix SparseMatrix::Identity(index_t n) {
+  SparseMatrix I(n, n);
+  I.col_idx.resize(n);
+  I.values.assign(n, 1.0);
+  for (index_t i = 0; i < n; i++) {
+    I.row_ptr[i + 1] = i + 1;
+    I.col_idx[i] = i;
+  }
+  return I;
+}
+
+// -------------------------------------------------------------------
+// Accessors
+// -------------------------------------------------------------------
+index_t SparseMatrix::get_num_rows() const {
+  return num_rows;
+}
+
+index_t SparseMatrix::get_num_cols() const {
+  return num_cols;
+}
+
+index_t SparseMatrix::nnz() const {
+  return static_cast<index_t>(values.size());
+}
+
+double SparseMatrix::density() const {
+  if (num_rows == 0 || num_cols == 0) {
+    return 0.0;
+  }
+  return static_cast<double>(nnz()) / (static_cast<double>(num_rows) * num_cols);
+}
+
+const std::vector<index_t>& SparseMatrix::get_row_ptr() const {
+  return row_ptr;
+}
+
+const std::vector<index_t>& SparseMatrix::get_col_idx() const {
+  return col_idx;
+}
+
+const vec& SparseMatrix::get_values() const {
+  return values;
+}
+
+double SparseMatrix::operator()(index_t i, index_t j) const {
+  if (i < 0 || i >= num_rows || j < 0 || j >= num_cols) {
+    throw std::out_of_range("Matrix index out of range");
+  }
+  auto first = col_idx.begin() + row_ptr[i];
+  auto last = col_idx.begin() + row_ptr[i + 1];
+  auto it = std::lower_bound(first, last, j);
+  return it != last && *it == j ? values[it - col_idx.begin()] : 0.0;
+}
+
+vec SparseMatrix::diagonal() const {
+  vec d(std::min(num_rows, num_cols));
+  for (index_t i = 0; i < static_cast<index_t>(d.size()); i++) {
+    d[i] = (*this)(i, i);
+  }
+  return d;
+}
+
+// -------------------------------------------------------------------
+// Conversion
+// -------------------------------------------------------------------
+Matrix SparseMatrix::to_dense(Layout layout) const {
+  Matrix result(num_rows, num_cols, Matrix::zeroed, layout);
+  double* r = result.memptr();
+  index_t col_step = layout == Layout::RowMajor ? 1 : num_rows;
+  index_t row_step = layout == Layout::RowMajor ? num_cols : 1;
+  parallel_for(0, num_rows, rows_per_chunk(num_rows, static_cast<double>(nnz())),
+               [&](std::size_t b, std::size_t e) {
+    for (index_t i = b; i < static_cast<index_t>(e); i++) {
+      for (index_t p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+        r[i * row_step + col_idx[p] * col_step] = values[p];
+      }
+    }
+  });
+  return result;
+}
+
+SparseMatrix SparseMatrix::prune(double drop_tol) const {
+  return build_rows(num_rows, num_cols, rows_per_chunk(num_rows, static_cast<double>(nnz())),
+                    [&](index_t begin, index_t end, std::vector<index_t>& c, vec& v, index_t* row_end) {
+    c.reserve(row_ptr[end] - row_ptr[begin]);
+    v.reserve(row_ptr[end] - row_ptr[begin]);
+    for (index_t i = begin; i < end; i++) {
+      for (index_t p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+        if (std::abs(values[p]) > drop_tol) {
+          c.push_back(col_idx[p]);
+          v.push_back(values[p]);
+        }
+      }
+      row_end[i] = static_cast<index_t>(c.size());
+    }
+  });
+}
+
+// counting sort by column; scanning the rows in order leaves the columns of
+// every transposed row ascending
+SparseMatrix SparseMatrix::transpose() const {
+  SparseMatrix T(num_cols, num_rows);
+  T.col_idx.resize(nnz());
+  T.values.resize(nnz());
+  for (index_t j : col_idx) {
+    T.row_ptr[j + 1]++;
+  }
+  for (index_t j = 0; j < num_cols; j++) {
+    T.row_ptr[j + 1] += T.row_ptr[j];
+  }
+  std::vector<index_t> next(T.row_ptr.begin(), T.row_ptr.end() - 1);
+  for (index_t i = 0; i < num_rows; i++) {
+    for (index_t p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+      index_t q = next[col_idx[p]]++;
+      T.col_idx[q] = i;
+      T.values[q] = values[p];
+    }
+  }
+  return T;
+}
+
+// -------------------------------------------------------------------
+// Properties
+// -------------------------------------------------------------------
+double SparseMatrix::norm_fro() const {
+  double sum = 0.0;
+  for (double x : values) {
+    sum += x * x;
+  }
+  return std::sqrt(sum);
+}
+
+// every stored entry is compared with its mirror, which covers the pairs
+// where only one side is stored
+bool SparseMatrix::is_symmetric(double tol) const {
+  if (num_rows != num_cols) {
+    return false;
+  }
+  for (index_t i = 0; i < num_rows; i++) {
+    for (index_t p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+      if (!(std::abs(values[p] - (*this)(col_idx[p], i)) <= tol)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// -------------------------------------------------------------------
+// Sums
+// -------------------------------------------------------------------
+SparseMatrix SparseMatrix::add_scaled(const SparseMatrix& other, double beta) const {
+  if (num_rows != other.num_rows || num_cols != other.num_cols) {
+    throw InvalidMatrixSize("Matrix dimensions must match for addition");
+  }
+  double work = static_cast<double>(nnz() + other.nnz());
+  return build_rows(num_rows, num_cols, rows_per_chunk(num_rows, work),
+                    [&](index_t begin, index_t end, std::vector<index_t>& c, vec& v, index_t* row_end) {
+    index_t bound = row_ptr[end] - row_ptr[begin] + other.row_ptr[end] - other.row_ptr[begin];
+    c.reserve(bound);
+    v.reserve(bound);
+    // merge of two ascending column lists
+    for (index_t i = begin; i < end; i++) {
+      index_t p = row_ptr[i], p_end = row_ptr[i + 1];
+      index_t q = other.row_ptr[i], q_end = other.row_ptr[i + 1];
+      while (p < p_end || q < q_end) {
+        index_t jp = p < p_end ? col_idx[p] : num_cols;
+        index_t jq = q < q_end ? other.col_idx[q] : num_cols;
+        if (jp < jq) {
+          c.push_back(jp);
+          v.push_back(values[p++]);
+        } else if (jq < jp) {
+          c.push_back(jq);
+          v.push_back(beta * other.values[q++]);
+        } else {
+          c.push_back(jp);
+          v.push_back(values[p++] + beta * other.values[q++]);
+        }
+      }
+      row_end[i] = static_cast<index_t>(c.size());
+    }
+  });
+}
+
+SparseMatrix SparseMatrix::operator+(const SparseMatrix& other) const {
+  return add_scaled(other, 1.0);
+}
+
+SparseMatrix SparseMatrix::operator-(const SparseMatrix& other) const {
+  return add_scaled(other, -1.0);
+}
+
+SparseMatrix SparseMatrix::operator*(double s) const {
+  SparseMatrix result = *this;
+  for (double& x : result.values) {
+    x *= s;
+  }
+  return result;
+}
+
+SparseMatrix operator*(double s, const SparseMatrix& A) {
+  return A * s;
+}
+
+// -------------------------------------------------------------------
+// Products
+// -------------------------------------------------------------------
+SparseMatrix SparseMatrix::operator*(const SparseMatrix& other) const {
+  return multiply(other, 0.0);
+}
+
+SparseMatrix SparseMatrix::multiply(const SparseMatrix& other, double drop_tol) const {
+  if (num_cols != other.num_rows) {
+    throw InvalidMatrixSize("Matrix dimensions incompatible for multiplication");
+  }
+  index_t n = other.num_cols;
+  // multiply-adds per row decide the chunking; a chunk also clears a scratch
+  // row of n entries, so it gets at least that much work
+  double flops = 0.0;
+  for (index_t k : col_idx) {
+    flops += static_cast<double>(other.row_ptr[k + 1] - other.row_ptr[k]);
+  }
+  double per_row = std::max(flops / std::max<double>(num_rows, 1.0), 1.0);
+  std::size_t chunk_rows = std::max(rows_per_chunk(num_rows, flops),
+                                    static_cast<std::size_t>(static_cast<double>(n) / per_row));
+
+  return build_rows(num_rows, n, chunk_rows,
+                    [&](index_t begin, index_t end, std::vector<index_t>& c, vec& v, index_t* row_end) {
+    vec acc(n, 0.0);
+    std::vector<index_t> last_row(n, -1);
+    std::vector<index_t> pattern;
+    for (index_t i = begin; i < end; i++) {
+      pattern.clear();
+      for (index_t p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+        index_t k = col_idx[p];
+        double a = values[p];
+        for (index_t q = other.row_ptr[k]; q < other.row_ptr[k + 1]; q++) {
+          index_t j = other.col_idx[q];
+          if (last_row[j] != i) {
+            last_row[j] = i;
+            pattern.push_back(j);
+            acc[j] = a * other.values[q];
+          } else {
+            acc[j] += a * other.values[q];
+          }
+        }
+      }
+      std::sort(pattern.begin(), pattern.end());
+      for (index_t j : pattern) {
+        if (std::abs(acc[j]) > drop_tol) {
+          c.push_back(j);
+          v.push_back(acc[j]);
+        }
+      }
+      row_end[i] = static_cast<index_t>(c.size());
+    }
+  });
+}
+
+Matrix SparseMatrix::operator*(const Matrix& X) const {
+  if (num_cols != X.get_num_rows()) {
+    throw InvalidMatrixSize("Matrix dimensions incompatible for multiplication");
+  }
+  index_t k = num_cols;
+  index_t m = X.get_num_cols();
+  Layout layout = X.get_layout();
+  Matrix Y(num_rows, m, Matrix::uninitialized, layout);
+  const double* x = X.memptr();
+  double* y = Y.memptr();
+  std::size_t chunk_rows = rows_per_chunk(num_rows, static_cast<double>(nnz()) * m + num_rows * m);
+
+  if (layout == Layout::RowMajor) {
+    // row i of Y is a combination of the rows of X
+    parallel_for(0, num_rows, chunk_rows, [&](std::size_t b, std::size_t e) {
+      for (index_t i = b; i < static_cast<index_t>(e); i++) {
+        double* yi = y + i * m;
+        std::fill(yi, yi + m, 0.0);
+        for (index_t p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+          const double* xk = x + col_idx[p] * m;
+          double a = values[p];
+          for (index_t j = 0; j < m; j++) {
+            yi[j] += a * xk[j];
+          }
+        }
+      }
+    });
+  } else {
+    // one sparse dot per element, column by column within the chunk
+    parallel_for(0, num_rows, chunk_rows, [&](std::size_t b, std::size_t e) {
+      for (index_t j = 0; j < m; j++) {
+        const double* xj = x + j * k;
+        double* yj = y + j * num_rows;
+        for (index_t i = b; i < static_cast<index_t>(e); i++) {
+          double sum = 0.0;
+          for (index_t p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+            sum += values[p] * xj[col_idx[p]];
+          }
+          yj[i] = sum;
+        }
+      }
+    });
+  }
+  return Y;
+}
+
+vec SparseMatrix::operator*(const vec& x) const {
+  if (num_cols != static_cast<index_t>(x.size())) {
+    throw InvalidMatrixSize("Matrix dimensions incompatible for multiplication");
+  }
+  vec y(num_rows);
+  parallel_for(0, num_rows, rows_per_chunk(num_rows, static_cast<double>(nnz()) + num_rows),
+               [&](std::size_t b, std::size_t e) {
+    for (index_t i = b; i < static_cast<index_t>(e); i++) {
+      double sum = 0.0;
+      for (index_t p = row_ptr[i]; p < row_ptr[i + 1]; p++) {
+        sum += values[p] * x[col_idx[p]];
+      }
+      y[i] = sum;
+    }
+  });
+  return y;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Output buffer for bulk text formatting of doubles
+ *
+ * Numbers are formatted with std::to_chars straight into a large character
+ * buffer which is handed to the stream in big blocks, instead of going
+ * through the iostream formatting machinery once per element.
+ */
+class TextBuffer {
+private:
+  static constexpr size_t flush_size = 1 << 20; // flush to the stream every ~1 MiB
+  static constexpr size_t max_number = 400; // widest fixed-notation double with some digits
+
+  std::ostream& out;
+  std::string buffer;
+  size_t used;
+
+  // make sure at least n more characters fit without reallocating
+  void reserve(size_t n) {
+    if (used + n > buffer.size()) {
+      flush();
+    }
+    if (n > buffer.size()) {
+      buffer.resize(n);
+    }
+  }
+
+public:
+  // the exact decimal expansion of a double has at most 767 significant
+  // digits, so a larger %g precision only adds zeros that %g drops anyway
+  static constexpr int max_significant_digits = 767;
+
+  // size_hint is the expected amount of output, used to avoid allocating a
+  // full block for small matrices
+  TextBuffer(std::ostream& stream, size_t size_hint)
+    : out(stream), buffer(std::min(size_hint, flush_size) + max_number, '\0'), used(0) {}
+
+  ~TextBuffer() { flush(); }
+
+  void flush() {
+    out.write(buffer.data(), used);
+    used = 0;
+  }
+
+  void put(char c) {
+    reserve(1);
+    buffer[used++] = c;
+  }
+
+  void put(const char* s, size_t n) {
+    reserve(n);
+    std::memcpy(&buffer[used], s, n);
+    used += n;
+  }
+
+  // shortest representation that reads back to exactly the same double
+  void put_roundtrip(double x) {
+    reserve(max_number);
+    char* first = &buffer[used];
+    auto res = std::to_chars(first, first + max_number, x);
+    used += res.ptr - first;
+  }
+
+  // %.{precision}g style output
+  void put_general(double x, int precision) {
+    precision = std::min(precision, max_significant_digits);
+    size_t n = max_number + std::max(precision, 0);
+    reserve(n);
+    char* first = &buffer[used];
+    auto res = std::to_chars(first, first + n, x, std::chars_format::general, precision);
+    used += res.ptr - first;
+  }
+
+  // %{width}.{precision}f style output, right aligned like std::setw
+  void put_fixed(double x, int precision, int width) {
+    size_t n = max_number + std::max(precision, 0);
+    reserve(n + std::max(width, 0));
+    char* first = &buffer[used];
+    auto res = std::to_chars(first, first + n, x, std::chars_format::fixed, precision);
+    int len = static_cast<int>(res.ptr - first);
+    if (len < width) {
+      std::memmove(first + (width - len), first, len);
+      std::memset(first, ' ', width - len);
+      len = width;
+    }
+    used += len;
+  }
+};
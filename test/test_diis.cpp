@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <armadillo>
+#include <deque>
+#include "matrix.h"
+#include "diis.hpp"
+#include "test_helpers.hpp"
+
+// this file includes tests for the DIIS accelerator: coefficients against
+// the subspace system solved by Armadillo, and convergence of a linear
+// fixed-point iteration
+
+// DIIS coefficients for the errors in es, solved from scratch
+static arma::vec reference_coefficients(const std::deque<Matrix>& es) {
+    int m = es.size();
+    arma::mat A = arma::zeros(m + 1, m + 1);
+    arma::vec rhs(m + 1);
+    for (int i = 0; i < m; ++i) {
+        rhs(i) = 0.0;
+    }
+    rhs(m) = -1.0;
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < m; ++j) {
+            A(i, j) = arma::accu(to_arma(es[i]) % to_arma(es[j]));
+        }
+        A(i, m) = A(m, i) = -1.0;
+    }
+    arma::vec x = arma::solve(A, rhs);
+    arma::vec c(m);
+    for (int i = 0; i < m; ++i) {
+        c(i) = x(i);
+    }
+    return c;
+}
+
+TEST(DIIS, MatchesSubspaceSystemAfterWrapAround) {
+    int n = 6;
+    DIIS diis(4);
+    std::deque<Matrix> fs, es;
+
+    for (int k = 0; k < 9; ++k) {
+        Matrix F = random_symmetric_matrix(n);
+        Matrix E = Matrix::Random(n, n);
+        fs.push_back(F);
+        es.push_back(E);
+        if (fs.size() > 4) {
+            fs.pop_front();
+            es.pop_front();
+        }
+        diis.extrapolate(F, E);
+
+        ASSERT_EQ(diis.size(), static_cast<index_t>(es.size()));
+        arma::vec c_ref = reference_coefficients(es);
+        EXPECT_LT(max_abs_error_vec(diis.coefficients(), c_ref), 1e-10);
+
+        arma::mat F_ref = arma::zeros(n, n);
+        for (std::size_t i = 0; i < fs.size(); ++i) {
+            F_ref = F_ref + to_arma(fs[i]) * c_ref(i);
+        }
+        EXPECT_TRUE(mats_close(F, F_ref, 1e-10, 1e-10));
+        EXPECT_NEAR(diis.error_norm(), E.norm_fro(), 1e-12);
+    }
+
+    diis.reset();
+    EXPECT_EQ(diis.size(), 0);
+    EXPECT_EQ(diis.max_vectors(), 4);
+}
+
+TEST(DIIS, AcceleratesLinearFixedPoint) {
+    // X = Q X + C with spectral radius 0.95: plain iteration needs about 360
+    // steps to reach 1e-8
+    int n = 12;
+    Matrix Q = random_symmetric_matrix(n);
+    EigsymResult eig = Q.eigsym();
+    double radius = std::max(std::abs(eig.eigenvalues.front()), std::abs(eig.eigenvalues.back()));
+    Q = Q * (0.95 / radius);
+    Matrix C = Matrix::Random(n, n);
+
+    DIIS diis(8);
+    Matrix X(n, n, Matrix::zeroed);
+    int iterations = 0;
+    for (; iterations < 100; ++iterations) {
+        Matrix G = Q * X + C;
+        Matrix E = G - X;
+        if (E.norm_fro() < 1e-8) {
+            break;
+        }
+        diis.extrapolate(G, E);
+        X = G;
+    }
+    EXPECT_LT(iterations, 60);
+
+    arma::mat X_ref = arma::solve(arma::eye(n, n) - to_arma(Q), to_arma(C));
+    EXPECT_TRUE(mats_close(X, X_ref, 1e-7, 0.0));
+}
+
+TEST(DIIS, DropsDependentVectors) {
+    Matrix F = random_symmetric_matrix(5);
+    Matrix E = Matrix::Random(5, 5);
+    DIIS diis(6);
+    Matrix F1 = F;
+    diis.extrapolate(F1, E);
+    // the same error again makes the subspace system singular
+    Matrix F2 = F * 2.0;
+    diis.extrapolate(F2, E);
+
+    EXPECT_EQ(diis.size(), 1);
+    ASSERT_EQ(diis.coefficients().size(), 1u);
+    EXPECT_DOUBLE_EQ(diis.coefficients()[0], 1.0);
+    EXPECT_TRUE(approx_equal(F2, F * 2.0, 0.0, 0.0));
+}
+
+TEST(DIIS, InvalidInput) {
+    EXPECT_THROW(DIIS(0), std::invalid_argument);
+
+    DIIS diis(3);
+    Matrix F = Matrix::Random(3, 3);
+    EXPECT_THROW(diis.extrapolate(F, Matrix::Random(3, 4)), InvalidMatrixSize);
+    diis.extrapolate(F, Matrix::Random(3, 3));
+    Matrix G = Matrix::Random(4, 4);
+    EXPECT_THROW(diis.extrapolate(G, Matrix::Random(4, 4)), InvalidMatrixSize);
+}
+
+TEST(DIIS, CommutatorMatchesArmadillo) {
+    int n = 20;
+    Matrix F = random_symmetric_matrix(n);
+    Matrix D = random_symmetric_matrix(n);
+    Matrix S = random_symmetric_matrix(n);
+    arma::mat f = to_arma(F), d = to_arma(D), s = to_arma(S);
+
+    Matrix E = DIIS::commutator(F, D, S);
+    EXPECT_TRUE(mats_close(E, f * d * s - s * d * f, 1e-12, 1e-12));
+    EXPECT_TRUE(approx_equal(E, E.transpose() * -1.0, 0.0, 0.0));
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include <armadillo>
+#include "matrix.h"
+#include "factorizations.hpp"
+#include "parallel.hpp"
+#include "test_helpers.hpp"
+
+// this file includes tests for the triangular solves and the Cholesky,
+// LDL^T and LU factor objects, checked against Armadillo
+
+// random symmetric positive definite matrix, diagonally shifted
+static Matrix random_spd_matrix(int n) {
+    Matrix A = random_symmetric_matrix(n);
+    for (int i = 0; i < n; ++i) {
+        A(i, i) += n;
+    }
+    return A;
+}
+
+TEST(TriangularSolve, AllCasesMatchArmadillo) {
+    int n = 90;
+    int m = 37;
+    // noise in the unreferenced triangle and a well conditioned diagonal
+    Matrix T = Matrix::Random(n, n);
+    for (int i = 0; i < n; ++i) {
+        T(i, i) += 4.0;
+    }
+    Matrix B = Matrix::Random(n, m);
+
+    for (Triangle uplo : {Triangle::Lower, Triangle::Upper}) {
+        for (bool transpose : {false, true}) {
+            for (bool unit : {false, true}) {
+                arma::mat tri = arma::zeros(n, n);
+                for (int i = 0; i < n; ++i) {
+                    for (int j = 0; j < n; ++j) {
+                        bool stored = uplo == Triangle::Lower ? j < i : j > i;
+                        if (stored) tri(i, j) = T(i, j);
+                    }
+                    tri(i, i) = unit ? 1.0 : T(i, i);
+                }
+                arma::mat op = transpose ? arma::mat(tri.t()) : tri;
+
+                Matrix X = solve_triangular(T, B, uplo, transpose, unit);
+                EXPECT_TRUE(mats_close(X, arma::solve(op, to_arma(B)), 1e-10, 1e-10));
+
+                vec b = B.copy_data();
+                b.resize(n);
+                vec x = solve_triangular(T, b, uplo, transpose, unit);
+                arma::vec r = op * arma::vec(x) - arma::vec(b);
+                EXPECT_LT(arma::abs(r).max(), 1e-10);
+            }
+        }
+    }
+}
+
+TEST(Cholesky, MatchesArmadillo) {
+    // several blocks, the last one partial
+    int n = 150;
+    Matrix A = random_spd_matrix(n);
+    arma::mat A_ref = to_arma(A);
+    CholeskyFactor chol(A);
+
+    arma::mat U_ref = arma::chol(A_ref);
+    EXPECT_TRUE(mats_close(chol.upper(), U_ref, 1e-10, 1e-10));
+    EXPECT_TRUE(mats_close(chol.lower(), U_ref.t(), 1e-10, 1e-10));
+
+    double log_det_ref = 0.0;
+    for (int i = 0; i < n; ++i) {
+        log_det_ref += 2.0 * std::log(U_ref(i, i));
+    }
+    EXPECT_NEAR(chol.log_det(), log_det_ref, 1e-9 * std::abs(log_det_ref));
+
+    Matrix B = Matrix::Random(n, 5);
+    EXPECT_TRUE(mats_close(chol.solve(B), arma::solve(A_ref, to_arma(B)), 1e-12, 1e-9));
+    Matrix B_col = B.to_layout(Layout::ColMajor);
+    Matrix X_col = chol.solve(B_col);
+    EXPECT_EQ(X_col.get_layout(), Layout::ColMajor);
+    EXPECT_TRUE(mats_close(X_col, arma::solve(A_ref, to_arma(B)), 1e-12, 1e-9));
+
+    Matrix A_inv = chol.inverse();
+    EXPECT_TRUE(A_inv.is_symmetric(0.0));
+    EXPECT_TRUE(mats_close(A_inv, arma::inv(A_ref), 1e-12, 1e-9));
+}
+
+TEST(Cholesky, IndependentOfThreadCount) {
+    int threads = get_num_threads();
+    Matrix A = random_spd_matrix(200);
+    Matrix B = Matrix::Random(200, 50);
+
+    set_num_threads(1);
+    CholeskyFactor serial(A);
+    Matrix X_serial = serial.solve(B);
+    set_num_threads(4);
+    CholeskyFactor parallel(A);
+    Matrix X_parallel = parallel.solve(B);
+    set_num_threads(threads);
+
+    EXPECT_TRUE(approx_equal(serial.upper(), parallel.upper(), 0.0, 0.0));
+    EXPECT_TRUE(approx_equal(X_serial, X_parallel, 0.0, 0.0));
+}
+
+TEST(Cholesky, RejectsInvalidInput) {
+    EXPECT_THROW(CholeskyFactor(Matrix(3, 4, Matrix::zeroed)), InvalidMatrixSize);
+    EXPECT_THROW(CholeskyFactor(Matrix::Random(4, 4)), InvalidMatrixSize);
+
+    // symmetric with one negative eigenvalue, found in a later block
+    Matrix A = random_spd_matrix(100);
+    A(80, 80) = -1000.0;
+    EXPECT_THROW(CholeskyFactor{A}, std::domain_error);
+
+    CholeskyFactor chol(random_spd_matrix(10));
+    EXPECT_THROW(chol.solve(vec(9, 1.0)), InvalidMatrixSize);
+}
+
+TEST(LDLT, FactorsIndefiniteMatrix) {
+    int n = 120;
+    Matrix A = random_symmetric_matrix(n);
+    arma::mat A_ref = to_arma(A);
+    LDLTFactor ldlt(A);
+
+    // P A P^T = L D L^T
+    const std::vector<index_t>& p = ldlt.permutation();
+    arma::mat PAP(n, n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            PAP(i, j) = A_ref(p[i], p[j]);
+        }
+    }
+    arma::mat L = to_arma(ldlt.lower());
+    EXPECT_TRUE(mats_close(ldlt.lower() * ldlt.block_diagonal() * ldlt.lower().transpose(),
+                           PAP, 1e-10, 1e-10));
+    for (int i = 0; i < n; ++i) {
+        EXPECT_EQ(L(i, i), 1.0);
+    }
+
+    arma::vec evals;
+    arma::mat evecs;
+    arma::eig_sym(evals, evecs, A_ref);
+    index_t negative = 0;
+    for (arma::uword i = 0; i < evals.n_elem; ++i) {
+        negative += evals(i) < 0.0;
+    }
+    EXPECT_EQ(ldlt.num_negative(), negative);
+
+    Matrix B = Matrix::Random(n, 7);
+    EXPECT_TRUE(mats_close(ldlt.solve(B), arma::solve(A_ref, to_arma(B)), 1e-9, 1e-8));
+    EXPECT_TRUE(mats_close(ldlt.inverse(), arma::inv(A_ref), 1e-9, 1e-8));
+}
+
+TEST(LDLT, NeedsPivoting) {
+    // zero diagonal: unpivoted LDL^T breaks down at the first step
+    Matrix A(vec{0.0, 1.0, 2.0, 1.0, 0.0, 3.0, 2.0, 3.0, 0.0}, 3, 3);
+    LDLTFactor ldlt(A);
+    vec b{1.0, 2.0, 3.0};
+    vec x = ldlt.solve(b);
+    arma::vec ref = arma::solve(to_arma(A), arma::vec(b));
+    EXPECT_LT(max_abs_error_vec(x, ref), 1e-12);
+
+    EXPECT_THROW(LDLTFactor(Matrix(4, 4, Matrix::zeroed)), std::runtime_error);
+}
+
+TEST(LU, MatchesArmadillo) {
+    // several panels, the last one partial
+    int n = 150;
+    Matrix A = Matrix::Random(n, n);
+    arma::mat A_ref = to_arma(A);
+    LUFactor lu(A);
+
+    // P A = L U
+    const std::vector<index_t>& p = lu.permutation();
+    arma::mat PA(n, n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            PA(i, j) = A_ref(p[i], j);
+        }
+    }
+    EXPECT_TRUE(mats_close(lu.lower() * lu.upper(), PA, 1e-12, 1e-10));
+    // partial pivoting keeps every multiplier at most 1
+    EXPECT_LE(arma::abs(to_arma(lu.lower())).max(), 1.0);
+
+    Matrix B = Matrix::Random(n, 9);
+    EXPECT_TRUE(mats_close(lu.solve(B), arma::solve(A_ref, to_arma(B)), 1e-10, 1e-9));
+    Matrix X_col = lu.solve(B.to_layout(Layout::ColMajor));
+    EXPECT_EQ(X_col.get_layout(), Layout::ColMajor);
+    EXPECT_TRUE(mats_close(X_col, arma::solve(A_ref, to_arma(B)), 1e-10, 1e-9));
+    EXPECT_TRUE(mats_close(lu.inverse(), arma::inv(A_ref), 1e-10, 1e-9));
+
+    Matrix C = Matrix::Random(12, 12);
+    double det_ref = arma::det(to_arma(C));
+    EXPECT_NEAR(LUFactor(C).det(), det_ref, 1e-12 * std::max(1.0, std::abs(det_ref)));
+}
+
+TEST(LU, IndependentOfThreadCount) {
+    int threads = get_num_threads();
+    Matrix A = Matrix::Random(200, 200);
+    Matrix B = Matrix::Random(200, 30);
+
+    set_num_threads(1);
+    Matrix X_serial = LUFactor(A).solve(B);
+    set_num_threads(4);
+    Matrix X_parallel = LUFactor(A).solve(B);
+    set_num_threads(threads);
+
+    EXPECT_TRUE(approx_equal(X_serial, X_parallel, 0.0, 0.0));
+}
+
+TEST(LU, SingularMatrix) {
+    EXPECT_THROW(LUFactor(Matrix(3, 4, Matrix::zeroed)), InvalidMatrixSize);
+
+    // zero last column
+    LUFactor lu(Matrix(vec{2.0, 1.0, 0.0, 1.0, 3.0, 0.0, 3.0, 4.0, 0.0}, 3, 3));
+    EXPECT_EQ(lu.det(), 0.0);
+    EXPECT_THROW(lu.solve(vec{1.0, 2.0, 3.0}), std::runtime_error);
+    EXPECT_THROW(lu.inverse(), std::runtime_error);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <armadillo>
+#include "matrix.h"
+#include "fixed_matrix.hpp"
+#include "test_helpers.hpp"
+
+// this file includes tests for the compile-time sized FixedMatrix, checked
+// against Armadillo through the Matrix conversions
+
+template <int R, int C>
+FixedMatrix<R, C> random_fixed() {
+    return FixedMatrix<R, C>(Matrix::Random(R, C));
+}
+
+// the kernels are constexpr, so small expressions fold at compile time
+static_assert(Matrix2::Identity().trace() == 2.0, "constexpr identity");
+static_assert((Matrix2(std::array<double, 4>{1, 2, 3, 4}) *
+               Matrix2(std::array<double, 4>{5, 6, 7, 8}))(1, 0) == 43.0,
+              "constexpr product");
+
+TEST(FixedMatrix, ArithmeticMatchesArmadillo) {
+    FixedMatrix<3, 4> A = random_fixed<3, 4>();
+    FixedMatrix<4, 2> B = random_fixed<4, 2>();
+    FixedMatrix<3, 4> C = random_fixed<3, 4>();
+    arma::mat A_ref = to_arma(A);
+    arma::mat B_ref = to_arma(B);
+    arma::mat C_ref = to_arma(C);
+
+    EXPECT_TRUE(mats_close(A * B, A_ref * B_ref));
+    EXPECT_TRUE(mats_close(A + C, A_ref + C_ref));
+    EXPECT_TRUE(mats_close(A - C, A_ref - C_ref));
+    EXPECT_TRUE(mats_close(2.5 * A, A_ref * 2.5));
+    EXPECT_TRUE(mats_close(A.transpose(), A_ref.t()));
+    EXPECT_TRUE(mats_close(A.transpose() * C, A_ref.t() * C_ref));
+    EXPECT_NEAR(dot(A, C), arma::accu(A_ref % C_ref), 1e-14);
+    EXPECT_NEAR(A.norm_fro(), arma::norm(A_ref, "fro"), 1e-14);
+
+    Matrix4 M = random_fixed<4, 4>();
+    EXPECT_NEAR(M.trace(), arma::trace(to_arma(M)), 1e-14);
+}
+
+TEST(FixedMatrix, MatrixConversions) {
+    Matrix R = Matrix::Random(3, 3);
+    Matrix3 F(R.to_layout(Layout::ColMajor));
+    EXPECT_DOUBLE_EQ(F(2, 0), R(2, 0));
+
+    Matrix back = F;
+    EXPECT_TRUE(approx_equal(back, R, 0.0, 0.0));
+    EXPECT_EQ(F.to_matrix(Layout::ColMajor).get_layout(), Layout::ColMajor);
+
+    // fixed and runtime matrices mix through the implicit conversion
+    EXPECT_TRUE(mats_close(R * Matrix(F), to_arma(R) * to_arma(R), 1e-14, 1e-14));
+
+    EXPECT_THROW(Matrix3(Matrix::Random(3, 4)), InvalidMatrixSize);
+    EXPECT_THROW(F.at(3, 0), std::out_of_range);
+    EXPECT_DOUBLE_EQ(F.at(1, 1), R(1, 1));
+}
+
+TEST(FixedMatrix, Eigsym3MatchesArmadillo) {
+    for (int trial = 0; trial < 20; trial++) {
+        Matrix3 A = random_fixed<3, 3>();
+        Matrix3 S = A + A.transpose();
+
+        FixedEigsymResult<3> res = eigsym(S);
+        arma::vec w_ref;
+        arma::mat V_ref;
+        arma::eig_sym(w_ref, V_ref, to_arma(S));
+
+        for (int i = 0; i < 3; i++) {
+            EXPECT_NEAR(res.eigenvalues[i], w_ref(i), 1e-13);
+        }
+        // S V = V diag(w) and V^T V = I
+        Matrix3 W;
+        for (int i = 0; i < 3; i++) {
+            W(i, i) = res.eigenvalues[i];
+        }
+        EXPECT_LT((S * res.eigenvectors - res.eigenvectors * W).max_abs(), 1e-13);
+        EXPECT_LT((res.eigenvectors.transpose() * res.eigenvectors - Matrix3::Identity()).max_abs(), 1e-14);
+    }
+}
+
+// repeated eigenvalues, where closed-form 3x3 solvers lose accuracy
+TEST(FixedMatrix, EigsymDegenerateAndSmallSizes) {
+    Matrix3 S(std::array<double, 9>{2, 1, 1,
+                                    1, 2, 1,
+                                    1, 1, 2});
+    FixedEigsymResult<3> res = eigsym(S);
+    EXPECT_NEAR(res.eigenvalues[0], 1.0, 1e-15);
+    EXPECT_NEAR(res.eigenvalues[1], 1.0, 1e-15);
+    EXPECT_NEAR(res.eigenvalues[2], 4.0, 1e-14);
+
+    FixedEigsymResult<1> one = eigsym(FixedMatrix<1, 1>(std::array<double, 1>{-3.0}));
+    EXPECT_EQ(one.eigenvalues[0], -3.0);
+    EXPECT_EQ(one.eigenvectors(0, 0), 1.0);
+
+    Matrix4 A = random_fixed<4, 4>();
+    Matrix4 S4 = A + A.transpose();
+    FixedEigsymResult<4> res4 = eigsym(S4);
+    EigsymResult ref = Matrix(S4).eigsym();
+    for (int i = 0; i < 4; i++) {
+        EXPECT_NEAR(res4.eigenvalues[i], ref.eigenvalues[i], 1e-13);
+    }
+
+    Matrix2 N(std::array<double, 4>{1, 2, 3, 4});
+    EXPECT_THROW(eigsym(N), InvalidMatrixSize);
+}
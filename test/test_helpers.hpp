@@ -2,6 +2,7 @@
 
 #include <armadillo>
 #include "matrix.h"
+#include "arma_interop.hpp"
 #include <fstream>
 #include <iomanip>
 #include <cmath>
@@ -9,29 +10,7 @@
 #include <stdexcept>
 #include <random>
 
-// convert MatrixLibrary matrix to Armadillo format
-inline arma::mat to_arma(const Matrix& M) {
-    arma::mat A(M.get_num_rows(), M.get_num_cols());
-    for (int i = 0; i < M.get_num_rows(); ++i) {
-        for (int j = 0; j < M.get_num_cols(); ++j) {
-            A(i, j) = M(i, j);
-        }
-    }
-    return A;
-}
-
-// convert Armadillo matrix to MatrixLibrary matrix
-inline Matrix from_arma(const arma::mat& A) {
-    vec data;
-    data.reserve(A.n_rows * A.n_cols);
-    for (arma::uword i = 0; i < A.n_rows; ++i) {
-        for (arma::uword j = 0; j < A.n_cols; ++j) {
-            data.push_back(A(i, j));
-        }
-    }
-    return Matrix(data, static_cast<int>(A.n_rows),
-                         static_cast<int>(A.n_cols));
-}
+// to_arma / from_arma come from arma_interop.hpp
 
 // compare MatrixLibrary matrix to Armadillo matrix using absolute 
 // and relative tolerances.
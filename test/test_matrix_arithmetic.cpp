@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
 #include <tuple> // for std::tuple in parameterized mul test
+#include <utility>
 #include "matrix.h"
 #include "test_helpers.hpp"
 
@@ -146,3 +149,424 @@ INSTANTIATE_TEST_SUITE_P(
         ShapeParam{3, 3, 3, 3}  // another square
     )
 );
+
+// ##### PRODUCTS AND SUMS WITH LAZY TRANSPOSES ##### //
+
+// (m, k, n): C = op(A) * op(B) is m x n with inner dimension k
+using TransposedMulParam = std::tuple<int, int, int>;
+
+class MatrixTransposedMulTest : public ::testing::TestWithParam<TransposedMulParam> {};
+
+TEST_P(MatrixTransposedMulTest, TransposedProductsMatchArmadillo) {
+    auto [m, k, n] = GetParam();
+
+    Matrix A_km = Matrix::Random(k, m);   // used as A^T
+    Matrix A_mk = Matrix::Random(m, k);
+    Matrix B_kn = Matrix::Random(k, n);
+    Matrix B_nk = Matrix::Random(n, k);   // used as B^T
+
+    arma::mat TN_ref = to_arma(A_km).t() * to_arma(B_kn);
+    arma::mat NT_ref = to_arma(A_mk) * to_arma(B_nk).t();
+    arma::mat TT_ref = to_arma(A_km).t() * to_arma(B_nk).t();
+
+    EXPECT_TRUE(mats_close(A_km.t() * B_kn, TN_ref, 1e-11, 1e-12))
+        << "A^T * B failed for " << m << "x" << k << "x" << n;
+    EXPECT_TRUE(mats_close(A_mk * B_nk.t(), NT_ref, 1e-11, 1e-12))
+        << "A * B^T failed for " << m << "x" << k << "x" << n;
+    EXPECT_TRUE(mats_close(A_km.t() * B_nk.t(), TT_ref, 1e-11, 1e-12))
+        << "A^T * B^T failed for " << m << "x" << k << "x" << n;
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TransposedMulShapes,
+    MatrixTransposedMulTest,
+    ::testing::Values(
+        TransposedMulParam{1, 1, 1},
+        TransposedMulParam{3, 5, 2},
+        TransposedMulParam{2, 1, 7},
+        TransposedMulParam{70, 300, 45},  // inner dimension spans two k blocks
+        TransposedMulParam{130, 20, 300}  // several row and column blocks
+    )
+);
+
+// every product has a native kernel and a BLAS path, they must agree
+TEST(MatrixBackend, ProductsAgreeAcrossBackends) {
+    Matrix A = Matrix::Random(70, 300);
+    Matrix B = Matrix::Random(300, 45);
+    Matrix C = Matrix::Random(45, 300);
+    arma::mat A_ref = to_arma(A), B_ref = to_arma(B), C_ref = to_arma(C);
+
+    Backend saved = get_backend();
+    for (Backend backend : {Backend::Native, Backend::Blas}) {
+        if (!backend_available(backend)) {
+            EXPECT_THROW(set_backend(backend), std::runtime_error);
+            continue;
+        }
+        set_backend(backend);
+        EXPECT_EQ(get_backend(), backend);
+
+        EXPECT_TRUE(mats_close(A * B, A_ref * B_ref, 1e-11, 1e-12));
+        EXPECT_TRUE(mats_close(B.t() * B, B_ref.t() * B_ref, 1e-11, 1e-12));
+        EXPECT_TRUE(mats_close(A * C.t(), A_ref * C_ref.t(), 1e-11, 1e-12));
+    }
+    set_backend(saved);
+}
+
+TEST(MatrixTransposeView, SumsAndConversion) {
+    Matrix A = Matrix::Random(70, 45);
+    Matrix B = Matrix::Random(45, 70);
+    Matrix C = Matrix::Random(70, 45);
+    Matrix S = Matrix::Random(33, 33);
+    arma::mat A_ref = to_arma(A), B_ref = to_arma(B), C_ref = to_arma(C);
+
+    EXPECT_TRUE(mats_close(A + B.t(), A_ref + B_ref.t()));
+    EXPECT_TRUE(mats_close(B.t() + A, B_ref.t() + A_ref));
+    EXPECT_TRUE(mats_close(A - B.t(), A_ref - B_ref.t()));
+    EXPECT_TRUE(mats_close(B.t() - A, B_ref.t() - A_ref));
+    EXPECT_TRUE(mats_close(A.t() + C.t(), A_ref.t() + C_ref.t()));
+    EXPECT_TRUE(mats_close(A.t() - C.t(), A_ref.t() - C_ref.t()));
+
+    Matrix sym = S + S.t();
+    EXPECT_TRUE(sym.is_symmetric(0.0));
+
+    // views index the original, materialize on assignment and undo with t()
+    auto At = A.t();
+    EXPECT_EQ(At.get_num_rows(), 45);
+    EXPECT_EQ(At.get_num_cols(), 70);
+    EXPECT_DOUBLE_EQ(At(3, 60), A(60, 3));
+    Matrix At_copy = At;
+    EXPECT_TRUE(mats_close(At_copy, A_ref.t()));
+    EXPECT_TRUE(&At.t() == &A);
+
+    Matrix x = Matrix::Random(70, 1);
+    vec y = A.t() * x.copy_data();
+    EXPECT_TRUE(mats_close(Matrix(y, 45, 1), A_ref.t() * to_arma(x), 1e-12, 1e-12));
+
+    EXPECT_THROW(A * A.t().t(), InvalidMatrixSize);
+    EXPECT_THROW(A + A.t(), InvalidMatrixSize);
+    EXPECT_THROW(A.t() * B.t() * A, InvalidMatrixSize);
+}
+
+// ##### ELEMENTWISE KERNELS AND REDUCTIONS ##### //
+
+// map/zip against the same operations done in Armadillo
+TEST_P(MatrixSizeTest, MapAndZipMatchArmadilloForSize) {
+    int n = GetParam();
+
+    Matrix A = Matrix::Random(n, n);
+    Matrix B = Matrix::Random(n, n);
+
+    Matrix C_mat_lib = zip(A.map([](double x) { return 2.0 * x + 1.0; }), B,
+                           [](double a, double b) { return a - 3.0 * b; });
+
+    arma::mat C_ref = to_arma(A) * 2.0 + arma::ones(n, n) - to_arma(B) * 3.0;
+
+    EXPECT_TRUE(mats_close(C_mat_lib, C_ref))
+        << "map/zip failed for size " << n << "x" << n;
+}
+
+// sizes larger than one chunk so the worker threads take part
+TEST(MatrixReductions, BuiltinsMatchArmadillo) {
+    Matrix A = Matrix::Random(70, 130);
+    Matrix B = Matrix::Random(130, 70);
+    Matrix C = Matrix::Random(70, 130) * -1.0;
+
+    arma::mat A_ref = to_arma(A);
+    arma::mat B_ref = to_arma(B);
+    arma::mat C_ref = to_arma(C);
+
+    EXPECT_NEAR(A.sum(), arma::accu(A_ref), 1e-9);
+    EXPECT_NEAR(A.norm_fro(), arma::norm(A_ref, "fro"), 1e-10);
+    EXPECT_DOUBLE_EQ(C.max_abs(), arma::abs(C_ref).max());
+    // a NaN is not dropped, wherever it falls relative to larger values
+    for (int idx : {0, 1, 4567, 70 * 130 - 1}) {
+        Matrix N = C;
+        N.memptr()[idx] = std::numeric_limits<double>::quiet_NaN();
+        EXPECT_TRUE(std::isnan(N.max_abs())) << "NaN at " << idx;
+    }
+    EXPECT_NEAR(dot(A, C), arma::trace(A_ref.t() * C_ref), 1e-9);
+    EXPECT_NEAR(trace_prod(A, B), arma::trace(A_ref * B_ref), 1e-9);
+    EXPECT_NEAR(rms_diff(A, C), arma::norm(A_ref - C_ref, "fro") / std::sqrt(70.0 * 130.0), 1e-12);
+
+    Matrix S = A * A.t();
+    EXPECT_NEAR(S.trace(), arma::trace(A_ref * A_ref.t()), 1e-9);
+
+    // generic reduce: count of elements above one half
+    double count = A.reduce(0.0, [](double acc, double x) { return acc + (x > 0.5); },
+                            [](double x, double y) { return x + y; });
+    double count_ref = arma::accu(A_ref > 0.5);
+    EXPECT_DOUBLE_EQ(count, count_ref);
+}
+
+// chunking is fixed, so the result must be bit-for-bit the same on any thread count
+TEST(MatrixReductions, IndependentOfThreadCount) {
+    Matrix A = Matrix::Random(400, 400);
+    Matrix B = Matrix::Random(400, 400);
+
+    set_num_threads(1);
+    double sum_1 = A.sum();
+    double dot_1 = dot(A, B);
+    double tr_1 = trace_prod(A, B);
+    Matrix C_1 = A + B;
+
+    set_num_threads(4);
+    EXPECT_EQ(get_num_threads(), 4);
+    EXPECT_EQ(A.sum(), sum_1);
+    EXPECT_EQ(dot(A, B), dot_1);
+    EXPECT_EQ(trace_prod(A, B), tr_1);
+    EXPECT_DOUBLE_EQ(max_abs_error(A + B, to_arma(C_1)), 0.0);
+
+    set_num_threads(0); // back to default
+}
+
+TEST(MatrixReductions, ShapeMismatchThrows) {
+    Matrix A = Matrix::Random(3, 4);
+    Matrix B = Matrix::Random(4, 3);
+
+    EXPECT_THROW(A - B, InvalidMatrixSize);
+    EXPECT_THROW(dot(A, B), InvalidMatrixSize);
+    EXPECT_THROW(trace_prod(A, A), InvalidMatrixSize);
+    EXPECT_NO_THROW(trace_prod(A, B));
+}
+
+// ##### MATRIX-VECTOR PRODUCTS ##### //
+
+// shapes cover narrow, wide (column-blocked x^T A) and multi-chunk cases
+using GemvParam = std::tuple<int, int>;
+
+class MatrixGemvTest : public ::testing::TestWithParam<GemvParam> {};
+
+TEST_P(MatrixGemvTest, GemvMatchesArmadilloForShape) {
+    auto [r, c] = GetParam();
+
+    Matrix A = Matrix::Random(r, c);
+    Matrix x = Matrix::Random(c, 1);
+    Matrix z = Matrix::Random(r, 1);
+
+    vec y = A * x.copy_data();        // A x
+    vec w = z.copy_data() * A;        // z^T A
+
+    arma::mat y_ref = to_arma(A) * to_arma(x);
+    arma::mat w_ref = to_arma(A).t() * to_arma(z);
+
+    EXPECT_TRUE(mats_close(Matrix(y, r, 1), y_ref, 1e-12, 1e-12))
+        << "A * x failed for shape " << r << "x" << c;
+    EXPECT_TRUE(mats_close(Matrix(w, c, 1), w_ref, 1e-12, 1e-12))
+        << "x^T * A failed for shape " << r << "x" << c;
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    GemvShapes,
+    MatrixGemvTest,
+    ::testing::Values(
+        GemvParam{1, 1},
+        GemvParam{3, 5},
+        GemvParam{7, 2},
+        GemvParam{2000, 40},  // several row chunks
+        GemvParam{20, 1500}   // column blocks
+    )
+);
+
+// symv reads the upper triangle only
+TEST(MatrixGemv, SymvUsesUpperTriangle) {
+    for (int n : {1, 4, 33, 400}) {
+        Matrix S = random_symmetric_matrix(n);
+        Matrix x = Matrix::Random(n, 1);
+
+        // scribble over the strict lower triangle, it must be ignored
+        Matrix U = S;
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < i; ++j)
+                U(i, j) = 1e6;
+
+        vec y = U.symv(x.copy_data());
+        arma::mat y_ref = to_arma(S) * to_arma(x);
+
+        EXPECT_TRUE(mats_close(Matrix(y, n, 1), y_ref, 1e-11, 1e-12))
+            << "symv failed for n = " << n;
+    }
+}
+
+TEST(MatrixGemv, SizeMismatchThrows) {
+    Matrix A = Matrix::Random(3, 4);
+    vec x3(3, 1.0), x4(4, 1.0);
+
+    EXPECT_THROW(A * x3, InvalidMatrixSize);
+    EXPECT_THROW(x4 * A, InvalidMatrixSize);
+    EXPECT_THROW(A.symv(x4), InvalidMatrixSize);
+    EXPECT_NO_THROW(A * x4);
+    EXPECT_NO_THROW(x3 * A);
+}
+
+// ##### DIAGONAL MATRICES ##### //
+
+TEST(DiagonalMatrix, ProductsMatchArmadillo) {
+    int r = 70, c = 45;
+    Matrix A = Matrix::Random(r, c);
+    Matrix dl = Matrix::Random(r, 1);
+    Matrix dr = Matrix::Random(c, 1);
+
+    DiagonalMatrix L = Matrix::diagmat(dl.copy_data());
+    DiagonalMatrix R = Matrix::diagmat(dr.copy_data());
+
+    arma::mat L_ref = arma::diagmat(to_arma(dl));
+    arma::mat R_ref = arma::diagmat(to_arma(dr));
+
+    EXPECT_TRUE(mats_close(L * A, L_ref * to_arma(A)));
+    EXPECT_TRUE(mats_close(A * R, to_arma(A) * R_ref));
+    EXPECT_TRUE(mats_close(Matrix(L * L), L_ref * L_ref));
+    EXPECT_TRUE(mats_close(Matrix(L * dl.copy_data(), r, 1), L_ref * to_arma(dl)));
+
+    // dense conversion, indexing and diagonal updates
+    Matrix S = Matrix::Random(c, c);
+    EXPECT_TRUE(mats_close(R.to_dense(), R_ref));
+    EXPECT_TRUE(mats_close(S + R, to_arma(S) + R_ref));
+    EXPECT_TRUE(mats_close(R - S, R_ref - to_arma(S)));
+    EXPECT_DOUBLE_EQ(R(3, 3), dr(3, 0));
+    EXPECT_DOUBLE_EQ(R(3, 4), 0.0);
+}
+
+// V D V^T only computes one triangle, it must still match the dense product
+TEST(DiagonalMatrix, CongruenceMatchesArmadillo) {
+    for (auto [n, k] : {std::tuple<int, int>{1, 1}, {5, 3}, {130, 130}, {150, 40}}) {
+        Matrix V = Matrix::Random(n, k);
+        Matrix d = Matrix::Random(k, 1);
+
+        Matrix S = congruence(V, Matrix::diagmat(d.copy_data()));
+        arma::mat S_ref = to_arma(V) * arma::diagmat(to_arma(d)) * to_arma(V).t();
+
+        EXPECT_TRUE(mats_close(S, S_ref, 1e-11, 1e-12))
+            << "congruence failed for " << n << "x" << k;
+        EXPECT_TRUE(S.is_symmetric(0.0));
+    }
+
+    // negative and zero weights take the signed path and skip columns
+    Matrix V = Matrix::Random(90, 60).to_layout(Layout::ColMajor);
+    vec d(60);
+    for (int j = 0; j < 60; ++j) {
+        d[j] = j % 3 == 0 ? 0.0 : (j % 3 == 1 ? -0.5 * j : 1.0 + j);
+    }
+    arma::vec d_ref(60);
+    for (int j = 0; j < 60; ++j) {
+        d_ref(j) = d[j];
+    }
+    Matrix S = congruence(V, Matrix::diagmat(d));
+    EXPECT_TRUE(mats_close(S, to_arma(V) * arma::diagmat(d_ref) * to_arma(V).t(), 1e-11, 1e-12));
+    EXPECT_TRUE(S.is_symmetric(0.0));
+    EXPECT_EQ(congruence(V, Matrix::diagmat(vec(60, 0.0))).max_abs(), 0.0);
+
+    // a NaN weight spreads to every element, as in V * D * V^T
+    d[7] = std::numeric_limits<double>::quiet_NaN();
+    Matrix S_nan = congruence(V, Matrix::diagmat(d));
+    EXPECT_TRUE(std::isnan(S_nan(0, 0)));
+    EXPECT_TRUE(std::isnan(S_nan(89, 3)));
+}
+
+TEST(DiagonalMatrix, SizeMismatchThrows) {
+    Matrix A = Matrix::Random(3, 4);
+    DiagonalMatrix D3 = Matrix::diagmat(vec(3, 1.0));
+    DiagonalMatrix D4 = Matrix::diagmat(vec(4, 1.0));
+
+    EXPECT_THROW(A * D3, InvalidMatrixSize);
+    EXPECT_THROW(D4 * A, InvalidMatrixSize);
+    EXPECT_THROW(A + D3, InvalidMatrixSize);
+    EXPECT_THROW(congruence(A, D3), InvalidMatrixSize);
+    EXPECT_THROW(D3(3, 0), std::out_of_range);
+    EXPECT_NO_THROW(D3 * A);
+    EXPECT_NO_THROW(congruence(A, D4));
+}
+
+// ##### storage layout ##### //
+
+TEST(MatrixLayout, ConversionKeepsValues) {
+    Matrix R = Matrix::Random(37, 21);
+    Matrix C = R.to_layout(Layout::ColMajor);
+
+    EXPECT_EQ(C.get_layout(), Layout::ColMajor);
+    EXPECT_DOUBLE_EQ(C(36, 3), R(36, 3));
+    EXPECT_DOUBLE_EQ(C.memptr()[1], R(1, 0));
+    EXPECT_EQ(C.copy_data(), R.copy_data());
+    // get_data() views the storage order in place
+    DataView view = C.get_data();
+    EXPECT_EQ(view.data(), std::as_const(C).memptr());
+    EXPECT_EQ(view.size(), C.get_size());
+    EXPECT_DOUBLE_EQ(view[1], R(1, 0));
+    EXPECT_TRUE(C == R);
+    EXPECT_TRUE(approx_equal(C.to_layout(Layout::RowMajor), R, 0.0, 0.0));
+
+    Matrix Z(3, 4, Layout::ColMajor);
+    Z(2, 1) = 5.0;
+    EXPECT_DOUBLE_EQ(Z.memptr()[1 * 3 + 2], 5.0);
+
+    // copies keep the layout
+    Matrix D = C;
+    EXPECT_EQ(D.get_layout(), Layout::ColMajor);
+}
+
+// every layout pair maps onto one of the N/T kernels
+TEST(MatrixLayout, MixedLayoutProductsMatchArmadillo) {
+    for (auto [m, k, n] : {std::tuple<int, int, int>{1, 1, 1}, {7, 5, 3}, {90, 70, 110}}) {
+        Matrix A = Matrix::Random(m, k);
+        Matrix B = Matrix::Random(k, n);
+        arma::mat ref = to_arma(A) * to_arma(B);
+
+        for (Layout la : {Layout::RowMajor, Layout::ColMajor}) {
+            for (Layout lb : {Layout::RowMajor, Layout::ColMajor}) {
+                Matrix Al = A.to_layout(la);
+                Matrix Bl = B.to_layout(lb);
+                Matrix P = Al * Bl;
+                EXPECT_EQ(P.get_layout(), la);
+                EXPECT_TRUE(mats_close(P, ref, 1e-11, 1e-12))
+                    << m << "x" << k << "x" << n << " layouts " << int(la) << int(lb);
+
+                Matrix Bt = B.t().eval().to_layout(lb);
+                EXPECT_TRUE(mats_close(Al * Bt.t(), ref, 1e-11, 1e-12));
+                EXPECT_TRUE(mats_close(Al.t() * Al, to_arma(A).t() * to_arma(A), 1e-11, 1e-12));
+            }
+        }
+    }
+}
+
+TEST(MatrixLayout, MixedLayoutSumsAndReductions) {
+    Matrix A = Matrix::Random(40, 25);
+    Matrix B = Matrix::Random(40, 25);
+    Matrix C = B.to_layout(Layout::ColMajor);
+    Matrix S = Matrix::Random(25, 40).to_layout(Layout::ColMajor);
+
+    EXPECT_TRUE(mats_close(A + C, to_arma(A) + to_arma(B)));
+    EXPECT_TRUE(mats_close(C - A, to_arma(B) - to_arma(A)));
+    EXPECT_EQ((C - A).get_layout(), Layout::ColMajor);
+    EXPECT_TRUE(mats_close(A + S.t(), to_arma(A) + to_arma(S).t()));
+    EXPECT_TRUE(mats_close(C.t() - S, to_arma(B).t() - to_arma(S)));
+
+    EXPECT_NEAR(dot(A, C), arma::accu(to_arma(A) % to_arma(B)), 1e-11);
+    EXPECT_NEAR(trace_prod(A, S), arma::trace(to_arma(A) * to_arma(S)), 1e-11);
+    EXPECT_NEAR(trace_prod(S, C), arma::trace(to_arma(S) * to_arma(B)), 1e-11);
+    EXPECT_NEAR(C.trace(), arma::trace(to_arma(B)), 1e-14);
+    EXPECT_NEAR(C.sum(), arma::accu(to_arma(B)), 1e-11);
+}
+
+TEST(MatrixLayout, ColMajorMatrixVectorAndDiagonal) {
+    Matrix A = Matrix::Random(33, 19);
+    Matrix C = A.to_layout(Layout::ColMajor);
+    Matrix x = Matrix::Random(19, 1);
+    Matrix y = Matrix::Random(33, 1);
+    arma::mat A_ref = to_arma(A);
+
+    EXPECT_TRUE(mats_close(Matrix(C * x.copy_data(), 33, 1), A_ref * to_arma(x), 1e-12, 1e-12));
+    EXPECT_TRUE(mats_close(Matrix(y.copy_data() * C, 1, 19), to_arma(y).t() * A_ref, 1e-12, 1e-12));
+
+    Matrix d_rows = Matrix::Random(33, 1);
+    Matrix d_cols = Matrix::Random(19, 1);
+    EXPECT_TRUE(mats_close(Matrix::diagmat(d_rows.copy_data()) * C,
+                           arma::diagmat(to_arma(d_rows)) * A_ref));
+    EXPECT_TRUE(mats_close(C * Matrix::diagmat(d_cols.copy_data()),
+                           A_ref * arma::diagmat(to_arma(d_cols))));
+
+    // symv reads the stored upper triangle, which is the logical lower one here
+    Matrix Sym = Matrix::Random(20, 20);
+    Sym = Sym + Sym.t();
+    Matrix v = Matrix::Random(20, 1);
+    EXPECT_TRUE(mats_close(Matrix(Sym.to_layout(Layout::ColMajor).symv(v.copy_data()), 20, 1),
+                           to_arma(Sym) * to_arma(v), 1e-12, 1e-12));
+}
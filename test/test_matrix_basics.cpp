@@ -25,6 +25,43 @@ TEST(MatrixBasics, SizesAndInitialization) {
     }
 }
 
+// dimensions and element counts are 64-bit, so rows * cols past 2^31 does
+// not wrap (too large to allocate in a unit test)
+TEST(MatrixBasics, SizesAre64Bit) {
+    static_assert(sizeof(index_t) == 8, "index_t must be 64-bit");
+    Matrix A(3, 4);
+    static_assert(std::is_same<decltype(A.get_size()), index_t>::value, "get_size returns index_t");
+    static_assert(std::is_same<decltype(A.t().get_num_rows()), index_t>::value, "views too");
+
+    const index_t rows = 50000;
+    const index_t cols = 50000;
+    EXPECT_THROW(Matrix(vec(10), rows, cols), InvalidMatrixSize);
+    EXPECT_GT(rows * cols, static_cast<index_t>(std::numeric_limits<int>::max()));
+}
+
+// construction tags: zeroed matches the default, uninitialized only
+// promises the shape and layout
+TEST(MatrixBasics, ConstructionTags) {
+    Matrix Z(300, 200, Matrix::zeroed, Layout::ColMajor);
+    EXPECT_EQ(Z.get_layout(), Layout::ColMajor);
+    EXPECT_EQ(Z.max_abs(), 0.0);
+    EXPECT_EQ(Matrix::Zeros(2000, 1000).max_abs(), 0.0);
+
+    Matrix U(30, 20, Matrix::uninitialized);
+    EXPECT_EQ(U.get_num_rows(), 30);
+    EXPECT_EQ(U.get_num_cols(), 20);
+    EXPECT_TRUE(U.owns_memory());
+    std::fill(U.memptr(), U.memptr() + U.get_size(), 2.0);
+    EXPECT_DOUBLE_EQ(U.sum(), 1200.0);
+
+    Matrix I = Matrix::Identity(4);
+    EXPECT_DOUBLE_EQ(I.sum(), 4.0);
+    EXPECT_DOUBLE_EQ(I.trace(), 4.0);
+
+    Matrix E(0, 5, Matrix::uninitialized);
+    EXPECT_EQ(E.get_size(), 0);
+}
+
 // construct from std::vector and compare to Armadillo
 
 TEST(MatrixBasics, FromVectorConstructorMatchesArmadillo) {
@@ -148,7 +185,8 @@ INSTANTIATE_TEST_SUITE_P(
         TransposeParam{3, 2},
         TransposeParam{1, 5},
         TransposeParam{5, 1},
-        TransposeParam{4, 4}
+        TransposeParam{4, 4},
+        TransposeParam{70, 45}  // several tiles, ragged edges
     )
 );
 
@@ -168,3 +206,158 @@ TEST(MatrixBasics, IsSymmetricBehavior) {
 
     EXPECT_FALSE(S.is_symmetric(1e-12));
 }
+
+// symmetry check across tile boundaries (tiles are 32 x 32)
+TEST(MatrixBasics, IsSymmetricLargeTiled) {
+    int n = 77;
+    Matrix S = random_symmetric_matrix(n);
+    EXPECT_TRUE(S.is_symmetric());
+
+    // break symmetry in the last partial tile, far from the diagonal
+    S(3, 75) += 1e-6;
+    EXPECT_FALSE(S.is_symmetric(1e-12));
+    EXPECT_TRUE(S.is_symmetric(1e-5));
+    S(3, 75) -= 1e-6;
+
+    // and right next to the diagonal inside a diagonal tile
+    S(40, 41) += 1e-6;
+    EXPECT_FALSE(S.is_symmetric(1e-12));
+    S(40, 41) -= 1e-6;
+
+    // NaN is never symmetric
+    S(10, 60) = std::nan("");
+    EXPECT_FALSE(S.is_symmetric(1e-12));
+
+    EXPECT_FALSE(Matrix::Random(3, 4).is_symmetric());
+}
+
+// approx_equal uses absolute and relative tolerances, operator== the defaults
+TEST(MatrixBasics, ApproxEqualTolerances) {
+    Matrix A(vec{1.0, 1e6, -2.0, 0.0}, 2, 2);
+    Matrix B = A;
+
+    EXPECT_TRUE(approx_equal(A, B, 0.0, 0.0));
+
+    B(0, 1) = 1e6 + 1e-5; // relative error 1e-11
+    EXPECT_TRUE(A == B);
+    EXPECT_FALSE(approx_equal(A, B, 1e-10, 0.0));
+    EXPECT_TRUE(approx_equal(A, B, 1e-10, 1e-10));
+
+    B(1, 1) = 1e-9; // only absolute tolerance helps near zero
+    EXPECT_FALSE(A == B);
+    EXPECT_TRUE(approx_equal(A, B, 1e-8, 1e-10));
+
+    EXPECT_FALSE(approx_equal(A, Matrix(vec{1.0, 1e6, -2.0, 0.0}, 4, 1)));
+}
+
+// eigsym can skip the symmetry check when the caller guarantees it
+TEST(MatrixBasics, EigsymSymmetryCheckOptional) {
+    Matrix A = random_symmetric_matrix(6);
+    A(0, 5) += 1e-3;
+
+    EXPECT_THROW(A.eigsym(), InvalidMatrixSize);
+    EXPECT_NO_THROW(A.eigsym(false));
+}
+
+// copy-on-write: copies share the buffer until one of them writes
+TEST(MatrixBasics, CopyOnWriteSharesUntilWrite) {
+    Matrix A = Matrix::Random(50, 40);
+    Matrix original = A;
+    EXPECT_FALSE(A.shares_storage_with(original));
+
+    A.set_copy_on_write();
+    Matrix B = A;
+    Matrix C;
+    C = B;
+    EXPECT_TRUE(B.copy_on_write());
+    EXPECT_TRUE(B.shares_storage_with(A));
+    EXPECT_TRUE(C.shares_storage_with(A));
+
+    // const reads and kernels leave the sharing intact
+    const Matrix& Bc = B;
+    EXPECT_DOUBLE_EQ(Bc(3, 4), original(3, 4));
+    EXPECT_EQ(B.get_data().data(), A.get_data().data());
+    EXPECT_TRUE(mats_close(Bc * Bc.t(), to_arma(original) * to_arma(original).t(), 1e-12, 1e-12));
+    EXPECT_TRUE(B.shares_storage_with(A));
+
+    // the first write clones only the writer
+    B(3, 4) = -1.0;
+    EXPECT_FALSE(B.shares_storage_with(A));
+    EXPECT_TRUE(C.shares_storage_with(A));
+    EXPECT_DOUBLE_EQ(A(3, 4), original(3, 4));
+    EXPECT_DOUBLE_EQ(B(3, 4), -1.0);
+
+    // writes through memptr() clone as well
+    double* p = C.memptr();
+    p[0] = 42.0;
+    EXPECT_DOUBLE_EQ(A(0, 0), original(0, 0));
+    EXPECT_DOUBLE_EQ(C(0, 0), 42.0);
+
+    // opting out gives a shared matrix its own buffer
+    Matrix D = A;
+    D.set_copy_on_write(false);
+    EXPECT_FALSE(D.shares_storage_with(A));
+    Matrix E = D;
+    EXPECT_FALSE(E.shares_storage_with(D));
+    EXPECT_TRUE(approx_equal(E, original, 0.0, 0.0));
+}
+
+// an adopted matrix is still copied, even with copy-on-write enabled
+TEST(MatrixBasics, CopyOnWriteCopiesAdoptedMemory) {
+    vec buffer = {1, 2, 3, 4};
+    Matrix A = Matrix::adopt(buffer.data(), 2, 2);
+    A.set_copy_on_write();
+    Matrix B = A;
+    EXPECT_TRUE(B.owns_memory());
+    B(0, 0) = 9.0;
+    EXPECT_DOUBLE_EQ(buffer[0], 1.0);
+
+    Matrix C = B;
+    EXPECT_TRUE(C.shares_storage_with(B));
+}
+
+// seeded Random is Philox4x32-10: counter 0 under key 0 gives the published
+// known-answer words 6627e8d5 e169c58d bc57ac4c 9b00dbd8
+TEST(MatrixBasics, SeededRandomMatchesPhiloxKnownAnswer) {
+    Matrix R = Matrix::Random(1, 2, 0, 0);
+    double first = static_cast<double>(0x6627e8d5e169c58dULL >> 11) * 0x1.0p-53;
+    double second = static_cast<double>(0xbc57ac4c9b00dbd8ULL >> 11) * 0x1.0p-53;
+    EXPECT_EQ(R(0, 0), first);
+    EXPECT_EQ(R(0, 1), second);
+}
+
+// same seed and stream give the same matrix for any thread count and shape
+// prefix; other seeds or streams give different values
+TEST(MatrixBasics, SeededRandomIsReproducible) {
+    int threads = get_num_threads();
+    set_num_threads(1);
+    Matrix serial = Matrix::Random(300, 301, 42, 7);
+    set_num_threads(4);
+    Matrix parallel = Matrix::Random(300, 301, 42, 7);
+    set_num_threads(threads);
+
+    EXPECT_TRUE(approx_equal(serial, parallel, 0.0, 0.0));
+
+    // element k depends only on k, so a shorter matrix is a prefix
+    Matrix prefix = Matrix::Random(1, 1001, 42, 7);
+    for (int k = 0; k < 1001; k++) {
+        ASSERT_EQ(prefix.memptr()[k], serial.memptr()[k]);
+    }
+
+    Matrix other_stream = Matrix::Random(300, 301, 42, 8);
+    Matrix other_seed = Matrix::Random(300, 301, 43, 7);
+    EXPECT_FALSE(approx_equal(serial, other_stream, 0.0, 0.0));
+    EXPECT_FALSE(approx_equal(serial, other_seed, 0.0, 0.0));
+
+    // uniform on [0, 1): range and first two moments
+    double mean = serial.sum() / serial.get_size();
+    double second = dot(serial, serial) / serial.get_size();
+    EXPECT_GE(serial.reduce(1.0, [](double a, double x) { return std::min(a, x); },
+                            [](double a, double b) { return std::min(a, b); }), 0.0);
+    EXPECT_LT(serial.max_abs(), 1.0);
+    EXPECT_NEAR(mean, 0.5, 0.005);
+    EXPECT_NEAR(second, 1.0 / 3.0, 0.005);
+
+    // unseeded calls draw fresh streams
+    EXPECT_FALSE(approx_equal(Matrix::Random(10, 10), Matrix::Random(10, 10), 0.0, 0.0));
+}
@@ -176,3 +176,306 @@ TEST(MatrixEigsym, EigsymDiagonalMatrix) {
     EXPECT_LT(recon_err, 1e-12);
     EXPECT_LT(orth_err,  1e-12);
 }
+
+// the native solver and the LAPACK backend must both match Armadillo
+TEST(MatrixEigsym, EigsymMatchesArmadilloForEachBackend) {
+    int n = 60;
+    Matrix S = random_symmetric_matrix(n);
+    arma::vec evals_ref;
+    arma::mat evecs_ref;
+    arma::eig_sym(evals_ref, evecs_ref, to_arma(S));
+
+    Backend saved = get_backend();
+    for (Backend backend : {Backend::Native, Backend::Blas}) {
+        if (!backend_available(backend)) continue;
+        set_backend(backend);
+
+        EigsymResult res = S.eigsym();
+        arma::vec evals = to_arma_vec(res.eigenvalues);
+        arma::mat V = to_arma(res.eigenvectors);
+
+        EXPECT_LT(arma::max(arma::abs(evals - evals_ref)), 1e-10);
+        EXPECT_LT(arma::norm(V * arma::diagmat(evals) * V.t() - to_arma(S), "fro"), 1e-10);
+        EXPECT_LT(arma::norm(V.t() * V - arma::eye(n, n), "fro"), 1e-10);
+    }
+    set_backend(saved);
+}
+
+// eigenvectors come back column-major so each one is a contiguous column;
+// a column-major input gives the same decomposition
+TEST(MatrixEigsym, EigenvectorsAreContiguousColumns) {
+    int n = 30;
+    Matrix A = Matrix::Random(n, n);
+    Matrix S = A + A.t();
+
+    EigsymResult res = S.eigsym();
+    ASSERT_EQ(res.eigenvectors.get_layout(), Layout::ColMajor);
+    for (int i = 0; i < n; ++i) {
+        EXPECT_EQ(&res.eigenvectors(i, 4), res.eigenvectors.memptr() + 4 * n + i);
+    }
+
+    EigsymResult res_col = S.to_layout(Layout::ColMajor).eigsym();
+    for (int i = 0; i < n; ++i) {
+        EXPECT_NEAR(res_col.eigenvalues[i], res.eigenvalues[i], 1e-11);
+    }
+
+    // residual ||S V - V diag(w)|| using the column-major factors directly
+    Matrix residual = S * res.eigenvectors - res.eigenvectors * Matrix::diagmat(res.eigenvalues);
+    EXPECT_LT(residual.max_abs(), 1e-10);
+}
+
+// large enough that the tridiagonalization splits into several parts; the
+// split depends only on the size, so the result is bit-for-bit the same on
+// any thread count
+TEST(MatrixEigsym, TridiagonalizationIndependentOfThreadCount) {
+    int n = 300;
+    Matrix S = random_symmetric_matrix(n);
+    int threads = get_num_threads();
+
+    set_num_threads(1);
+    TridiagonalResult one = S.householder_tridiagonalize(true);
+    set_num_threads(4);
+    TridiagonalResult four = S.householder_tridiagonalize(true);
+    set_num_threads(threads);
+
+    EXPECT_EQ(one.d, four.d);
+    EXPECT_EQ(one.e, four.e);
+    EXPECT_TRUE(approx_equal(one.Q_house, four.Q_house, 0.0, 0.0));
+
+    // Q^T S Q is the tridiagonal matrix (d, e)
+    Matrix T = one.Q_house.t() * S * one.Q_house;
+    double err = 0.0;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            double expected = i == j ? one.d[i]
+                            : i == j + 1 ? one.e[i]
+                            : j == i + 1 ? one.e[j] : 0.0;
+            err = std::max(err, std::abs(T(i, j) - expected));
+        }
+    }
+    EXPECT_LT(err, 1e-10);
+
+    Backend saved = get_backend();
+    set_backend(Backend::Native);
+    EigsymResult res = S.eigsym();
+    set_backend(saved);
+    arma::vec evals_ref;
+    arma::mat evecs_ref;
+    arma::eig_sym(evals_ref, evecs_ref, to_arma(S));
+    EXPECT_LT(arma::max(arma::abs(to_arma_vec(res.eigenvalues) - evals_ref)), 1e-9);
+}
+
+// QL queues its rotations and applies them in row panels; every element still
+// sees the rotations in order, so any thread count gives the same vectors
+TEST(MatrixEigsym, QLIndependentOfThreadCount) {
+    int n = 300;
+    Matrix S = random_symmetric_matrix(n);
+    TridiagonalResult tri = S.householder_tridiagonalize(false);
+    int threads = get_num_threads();
+
+    set_num_threads(1);
+    QLEigenResult one = S.QL(tri.d, tri.e);
+    set_num_threads(4);
+    QLEigenResult four = S.QL(tri.d, tri.e);
+    set_num_threads(threads);
+
+    EXPECT_EQ(one.eigenvalues, four.eigenvalues);
+    EXPECT_TRUE(approx_equal(one.Q_ql, four.Q_ql, 0.0, 0.0));
+    EXPECT_LT((one.Q_ql.t() * one.Q_ql - Matrix::Identity(n)).max_abs(), 1e-12);
+}
+
+// every method must match Armadillo, including odd sizes where the
+// round-robin schedule pairs one index with a dummy each round
+TEST(MatrixEigsym, JacobiMatchesArmadillo) {
+    for (int n : {1, 2, 7, 40, 101}) {
+        Matrix S = random_symmetric_matrix(n);
+        arma::vec evals_ref;
+        arma::mat evecs_ref;
+        arma::eig_sym(evals_ref, evecs_ref, to_arma(S));
+
+        for (EigsymMethod method : {EigsymMethod::HouseholderQL, EigsymMethod::Jacobi}) {
+            EigsymResult res = S.eigsym(method);
+            arma::vec evals = to_arma_vec(res.eigenvalues);
+            arma::mat V = to_arma(res.eigenvectors);
+
+            EXPECT_EQ(res.eigenvectors.get_layout(), Layout::ColMajor);
+            EXPECT_LT(arma::max(arma::abs(evals - evals_ref)), 1e-10) << "n = " << n;
+            EXPECT_LT(arma::norm(V * arma::diagmat(evals) * V.t() - to_arma(S), "fro"), 1e-10);
+            EXPECT_LT(arma::norm(V.t() * V - arma::eye(n, n), "fro"), 1e-10);
+        }
+    }
+
+    Matrix N = Matrix::Random(4, 4);
+    EXPECT_THROW(N.eigsym(EigsymMethod::Jacobi), InvalidMatrixSize);
+}
+
+// rounds rotate disjoint pairs in parallel; the schedule does not depend on
+// the thread count, so neither does the result
+TEST(MatrixEigsym, JacobiIndependentOfThreadCount) {
+    Matrix S = random_symmetric_matrix(120);
+    int threads = get_num_threads();
+
+    set_num_threads(1);
+    EigsymResult one = S.eigsym(EigsymMethod::Jacobi);
+    set_num_threads(4);
+    EigsymResult four = S.eigsym(EigsymMethod::Jacobi);
+    set_num_threads(threads);
+
+    EXPECT_EQ(one.eigenvalues, four.eigenvalues);
+    EXPECT_TRUE(approx_equal(one.eigenvectors, four.eigenvectors, 0.0, 0.0));
+}
+
+// graded positive definite matrix: the small eigenvalue is far below
+// eps * ||A||, so only a relative stopping test resolves it. The reference
+// is det(A) / lambda_max, both accurate to a few ulps
+TEST(MatrixEigsym, JacobiSmallEigenvaluesRelativeAccuracy) {
+    double a = 1.0, b = 1e-9, d = 1e-16;
+    Matrix S(vec{a, b, b, d}, 2, 2);
+    EigsymResult res = S.eigsym(EigsymMethod::Jacobi);
+
+    double lambda_max = res.eigenvalues[1];
+    double lambda_min = (a * d - b * b) / lambda_max;
+    EXPECT_NEAR(lambda_max, 1.0, 1e-15);
+    EXPECT_LT(std::abs(res.eigenvalues[0] - lambda_min) / lambda_min, 1e-14);
+}
+
+// a slightly perturbed matrix, as between late SCF iterations: the warm
+// solver must reach the accuracy of a fresh decomposition
+TEST(MatrixEigsym, WarmStartMatchesArmadillo) {
+    int n = 80;
+    Matrix S = random_symmetric_matrix(n);
+    EigsymResult previous = S.eigsym();
+    Matrix P = random_symmetric_matrix(n);
+    Matrix S2 = S + P * 1e-4;
+
+    arma::vec evals_ref;
+    arma::mat evecs_ref;
+    arma::eig_sym(evals_ref, evecs_ref, to_arma(S2));
+
+    for (int k : {1, 12, n}) {
+        EigsymResult res = S2.eigsym_warm(previous, k);
+        ASSERT_EQ(static_cast<int>(res.eigenvalues.size()), k);
+        ASSERT_EQ(res.eigenvectors.get_num_cols(), k);
+        EXPECT_EQ(res.eigenvectors.get_layout(), Layout::ColMajor);
+
+        arma::mat V = to_arma(res.eigenvectors);
+        arma::vec evals = to_arma_vec(res.eigenvalues);
+        for (int i = 0; i < k; ++i) {
+            EXPECT_NEAR(res.eigenvalues[i], evals_ref(i), 1e-10) << "k = " << k;
+        }
+        EXPECT_LT(arma::norm(to_arma(S2) * V - V * arma::diagmat(evals), "fro"), 1e-9);
+        EXPECT_LT(arma::norm(V.t() * V - arma::eye(k, k), "fro"), 1e-10);
+    }
+}
+
+// a guess from an unrelated matrix stalls the refinement, and the full
+// solver takes over
+TEST(MatrixEigsym, WarmStartFallsBackOnPoorGuess) {
+    int n = 40;
+    Matrix S = random_symmetric_matrix(n);
+    EigsymResult unrelated = random_symmetric_matrix(n).eigsym();
+
+    EigsymResult res = S.eigsym_warm(unrelated, 5);
+    EigsymResult ref = S.eigsym();
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_NEAR(res.eigenvalues[i], ref.eigenvalues[i], 1e-10);
+    }
+
+    EXPECT_THROW(S.eigsym_warm(unrelated, 0), InvalidMatrixSize);
+    EXPECT_THROW(S.eigsym_warm(unrelated, n + 1), InvalidMatrixSize);
+    EXPECT_THROW(random_symmetric_matrix(n + 1).eigsym_warm(unrelated, 5), InvalidMatrixSize);
+    EigsymResult partial = S.eigsym_warm(unrelated, 5);
+    EXPECT_THROW(S.eigsym_warm(partial, 6), InvalidMatrixSize);
+}
+
+// each result is the guess for the next matrix, as along an SCF run, so
+// later calls see only the k eigenpairs the previous one returned
+TEST(MatrixEigsym, WarmStartChainsPartialGuesses) {
+    int n = 90;
+    int k = 8;
+    // a diagonally dominant, Fock-like matrix
+    Matrix F = random_symmetric_matrix(n) * 0.05;
+    for (int i = 0; i < n; ++i) {
+        F(i, i) += i;
+    }
+    EigsymResult previous = F.eigsym();
+    // a wider partial guess than needed is accepted as well
+    previous = F.eigsym_warm(previous, 2 * k);
+    ASSERT_EQ(previous.eigenvectors.get_num_cols(), 2 * k);
+
+    for (int step = 0; step < 4; ++step) {
+        F = F + random_symmetric_matrix(n) * 1e-4;
+        EigsymResult res = F.eigsym_warm(previous, k);
+        ASSERT_EQ(static_cast<int>(res.eigenvalues.size()), k);
+
+        arma::vec evals_ref;
+        arma::mat evecs_ref;
+        arma::eig_sym(evals_ref, evecs_ref, to_arma(F));
+        arma::mat V = to_arma(res.eigenvectors);
+        for (int i = 0; i < k; ++i) {
+            EXPECT_NEAR(res.eigenvalues[i], evals_ref(i), 1e-10) << "step " << step;
+        }
+        EXPECT_LT(arma::norm(to_arma(F) * V - V * arma::diagmat(to_arma_vec(res.eigenvalues)), "fro"),
+                  1e-9);
+        EXPECT_LT(arma::norm(V.t() * V - arma::eye(k, k), "fro"), 1e-10);
+        previous = std::move(res);
+    }
+}
+
+// reference f(A) = V diag(f(w)) V^T from Armadillo's eigendecomposition
+template <typename F>
+static arma::mat arma_funm(const arma::mat& A, F f) {
+    arma::vec w;
+    arma::mat V;
+    arma::eig_sym(w, V, A);
+    arma::vec fw(w.n_elem);
+    for (arma::uword i = 0; i < w.n_elem; ++i) {
+        fw(i) = f(w(i));
+    }
+    return V * arma::diagmat(fw) * V.t();
+}
+
+TEST(MatrixFunctions, MatchArmadillo) {
+    int n = 90;
+    Matrix B = Matrix::Random(n, n);
+    Matrix S = B * B.t() * (1.0 / n) + Matrix::Identity(n) * 0.1;
+    arma::mat S_ref = to_arma(S);
+
+    Matrix R = S.sqrtm_sym();
+    EXPECT_TRUE(mats_close(R, arma_funm(S_ref, [](double w) { return std::sqrt(w); }), 1e-12, 1e-10));
+    EXPECT_TRUE(mats_close(R * R, S_ref, 1e-12, 1e-10));
+    EXPECT_TRUE(R.is_symmetric(0.0));
+
+    Matrix X = S.invsqrtm_sym();
+    EXPECT_TRUE(mats_close(X * S * X, arma::eye(n, n), 1e-10, 0.0));
+
+    Matrix A = random_symmetric_matrix(n) * 0.1;
+    Matrix E = A.expm_sym();
+    EXPECT_TRUE(mats_close(E, arma_funm(to_arma(A), [](double w) { return std::exp(w); }), 1e-12, 1e-10));
+    EXPECT_TRUE(mats_close(E.logm_sym(), to_arma(A), 1e-10, 1e-10));
+
+    // a function with both signs, and column-major input
+    Matrix C = A.to_layout(Layout::ColMajor).funm_sym([](double w) { return w * std::abs(w); });
+    EXPECT_TRUE(mats_close(C, arma_funm(to_arma(A), [](double w) { return w * std::abs(w); }), 1e-12, 1e-10));
+}
+
+// Lowdin orthogonalization with a nearly linearly dependent overlap matrix:
+// thresholding drops the dependent directions instead of amplifying them
+TEST(MatrixFunctions, ThresholdedInverseSqrt) {
+    int n = 60;
+    int k = 45;
+    Matrix C = Matrix::Random(n, k);
+    Matrix S = C * C.t();  // rank k, n - k eigenvalues at rounding level
+
+    Matrix X = S.invsqrtm_sym(1e-8);
+    Matrix P = X * S * X;  // projector onto the kept directions
+    EXPECT_NEAR(P.trace(), k, 1e-8);
+    EXPECT_LT((P * P - P).max_abs(), 1e-9);
+    EXPECT_TRUE(mats_close(S.sqrtm_sym(1e-8) * S.sqrtm_sym(1e-8), to_arma(S), 1e-10, 1e-10));
+
+    Matrix N = random_symmetric_matrix(n);
+    EXPECT_THROW(N.invsqrtm_sym(), std::domain_error);
+    EXPECT_THROW(N.sqrtm_sym(), std::domain_error);
+    EXPECT_THROW(S.logm_sym(), std::domain_error);
+    EXPECT_THROW(Matrix::Random(3, 4).expm_sym(), InvalidMatrixSize);
+}
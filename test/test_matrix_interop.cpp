@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "matrix.h"
+#include "arma_interop.hpp"
+#include "eigen_interop.hpp"
+#include "test_helpers.hpp"
+
+// this file includes tests for adopting external memory and the zero-copy
+// Armadillo / Eigen adapters
+
+// ##### adopted memory ##### //
+
+TEST(MatrixInterop, AdoptWritesThroughAndCopiesOwn) {
+    vec buffer = {1, 2, 3, 4, 5, 6};
+    Matrix A = Matrix::adopt(buffer.data(), 2, 3);
+
+    EXPECT_FALSE(A.owns_memory());
+    EXPECT_EQ(A.memptr(), buffer.data());
+    EXPECT_DOUBLE_EQ(A(1, 0), 4.0);
+
+    A(0, 2) = -3.0;
+    EXPECT_DOUBLE_EQ(buffer[2], -3.0);
+
+    // copies own their storage
+    Matrix B = A;
+    EXPECT_TRUE(B.owns_memory());
+    B(0, 0) = 100.0;
+    EXPECT_DOUBLE_EQ(buffer[0], 1.0);
+
+    // moves keep pointing at the buffer
+    Matrix C = std::move(A);
+    EXPECT_FALSE(C.owns_memory());
+    EXPECT_EQ(C.memptr(), buffer.data());
+    EXPECT_EQ(A.get_size(), 0);
+
+    // same-shape assignment writes into the adopted buffer
+    C = Matrix::Ones(2, 3) * 2.0;
+    EXPECT_EQ(C.memptr(), buffer.data());
+    EXPECT_DOUBLE_EQ(buffer[5], 2.0);
+
+    // a different shape replaces it with owned storage
+    C = Matrix::Ones(3, 3);
+    EXPECT_TRUE(C.owns_memory());
+    EXPECT_DOUBLE_EQ(buffer[5], 2.0);
+}
+
+TEST(MatrixInterop, AdoptedMatrixWorksWithKernels) {
+    Matrix R = Matrix::Random(40, 30);
+    vec buffer = R.copy_data();
+    Matrix A = Matrix::adopt(buffer.data(), 40, 30);
+
+    EXPECT_TRUE(mats_close(A * A.t(), to_arma(R) * to_arma(R).t(), 1e-11, 1e-12));
+    EXPECT_DOUBLE_EQ(A.sum(), R.sum());
+    EXPECT_THROW(Matrix::adopt(nullptr, 2, 2), InvalidMatrixSize);
+}
+
+// ##### Armadillo ##### //
+
+TEST(MatrixInterop, ArmaViewAliasesTranspose) {
+    Matrix M = Matrix::Random(5, 3);
+    arma::mat V = arma_view_transposed(M);
+
+    ASSERT_EQ(V.n_rows, 3u);
+    ASSERT_EQ(V.n_cols, 5u);
+    EXPECT_EQ(V.memptr(), M.memptr());
+    EXPECT_DOUBLE_EQ(V(2, 4), M(4, 2));
+
+    V(1, 0) = 7.5;
+    EXPECT_DOUBLE_EQ(M(0, 1), 7.5);
+}
+
+TEST(MatrixInterop, AdoptArmaTransposed) {
+    arma::mat A = arma::randu<arma::mat>(4, 6);
+    Matrix T = adopt_transposed(A);
+
+    ASSERT_EQ(T.get_num_rows(), 6);
+    ASSERT_EQ(T.get_num_cols(), 4);
+    EXPECT_DOUBLE_EQ(T(5, 3), A(3, 5));
+
+    // results assigned to the adopting matrix land in Armadillo's buffer
+    arma::mat expected = A * 2.0;
+    T = T * 2.0;
+    EXPECT_EQ(arma::norm(A - expected, "fro"), 0.0);
+}
+
+TEST(MatrixInterop, ArmaCopiesKeepOrientation) {
+    Matrix M = Matrix::Random(7, 4);
+    arma::mat A = to_arma(M);
+    ASSERT_EQ(A.n_rows, 7u);
+    EXPECT_EQ(max_abs_error(M, A), 0.0);
+
+    Matrix back = from_arma(A);
+    EXPECT_TRUE(back.owns_memory());
+    EXPECT_TRUE(approx_equal(back, M, 0.0, 0.0));
+}
+
+// ##### Eigen ##### //
+
+TEST(MatrixInterop, EigenViewsShareMemory) {
+    Matrix M = Matrix::Random(6, 4);
+    auto view = eigen_view(M);
+
+    EXPECT_EQ(view.data(), M.memptr());
+    EXPECT_DOUBLE_EQ(view(5, 1), M(5, 1));
+    view(2, 3) = -1.0;
+    EXPECT_DOUBLE_EQ(M(2, 3), -1.0);
+
+    RowMajorMatrixXd R = RowMajorMatrixXd::Random(3, 5);
+    Matrix A = adopt_eigen(R);
+    EXPECT_EQ(A.memptr(), R.data());
+    EXPECT_DOUBLE_EQ(A(2, 4), R(2, 4));
+
+    Eigen::MatrixXd C = Eigen::MatrixXd::Random(3, 5);
+    Matrix Ct = adopt_eigen_transposed(C);
+    EXPECT_EQ(Ct.get_num_rows(), 5);
+    EXPECT_DOUBLE_EQ(Ct(4, 2), C(2, 4));
+}
+
+TEST(MatrixInterop, EigenCopiesKeepOrientation) {
+    Matrix M = Matrix::Random(5, 8);
+    Eigen::MatrixXd E = to_eigen(M);
+    EXPECT_DOUBLE_EQ(E(4, 7), M(4, 7));
+
+    Matrix back = from_eigen(E);
+    EXPECT_TRUE(approx_equal(back, M, 0.0, 0.0));
+}
+
+// ##### column-major layout ##### //
+
+TEST(MatrixInterop, ColMajorSharesArmaBufferWithSameShape) {
+    arma::mat A = arma::randu<arma::mat>(6, 4);
+    Matrix M = adopt_arma(A);
+
+    EXPECT_EQ(M.get_layout(), Layout::ColMajor);
+    EXPECT_EQ(M.memptr(), A.memptr());
+    ASSERT_EQ(M.get_num_rows(), 6);
+    EXPECT_DOUBLE_EQ(M(5, 2), A(5, 2));
+
+    // products consume the shared buffer directly and match Armadillo
+    EXPECT_TRUE(mats_close(M.t() * M, A.t() * A, 1e-12, 1e-12));
+
+    arma::mat V = arma_view(M);
+    EXPECT_EQ(V.memptr(), A.memptr());
+    V(3, 1) = 9.0;
+    EXPECT_DOUBLE_EQ(M(3, 1), 9.0);
+
+    EXPECT_EQ(max_abs_error(M, to_arma(M)), 0.0);
+    EXPECT_THROW(arma_view_transposed(M), std::runtime_error);
+
+    Matrix R = Matrix::Random(2, 2);
+    EXPECT_THROW(arma_view(R), std::runtime_error);
+}
+
+TEST(MatrixInterop, ColMajorSharesEigenBuffer) {
+    Eigen::MatrixXd E = Eigen::MatrixXd::Random(5, 7);
+    Matrix M = adopt_eigen(E);
+
+    EXPECT_EQ(M.get_layout(), Layout::ColMajor);
+    EXPECT_EQ(M.memptr(), E.data());
+    EXPECT_DOUBLE_EQ(M(4, 6), E(4, 6));
+
+    auto view = eigen_view_colmajor(M);
+    view(0, 5) = -2.0;
+    EXPECT_DOUBLE_EQ(E(0, 5), -2.0);
+    EXPECT_TRUE(to_eigen(M) == E);
+    EXPECT_THROW(eigen_view(M), std::runtime_error);
+}
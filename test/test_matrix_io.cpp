@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include "matrix.h"
+#include "print_vec.hpp"
+#include "test_helpers.hpp"
+
+// this file includes tests for text output/input and printing
+
+// build a matrix with awkward values (negative, tiny, huge, non-terminating)
+static Matrix awkward_matrix() {
+    vec values = {1.0 / 3.0, -2.5,     1e-300,  6.02214076e23,
+                  0.0,       -0.0,     1e300,   -123456.789,
+                  0.1,       2.0 / 7., 5e-324,  42.0};
+    return Matrix(values, 3, 4);
+}
+
+// ##### round trip for every separator ##### //
+
+class TextFormatTest : public ::testing::TestWithParam<TextFormat> {};
+
+// default precision must read back bit-for-bit
+TEST_P(TextFormatTest, RoundTripIsExact) {
+    Matrix A = awkward_matrix();
+
+    std::stringstream ss;
+    Matrix::write_text(ss, A, GetParam());
+    Matrix B = Matrix::read_text(ss, GetParam());
+
+    ASSERT_EQ(B.get_num_rows(), A.get_num_rows());
+    ASSERT_EQ(B.get_num_cols(), A.get_num_cols());
+    for (int i = 0; i < A.get_num_rows(); ++i)
+        for (int j = 0; j < A.get_num_cols(); ++j)
+            EXPECT_EQ(B(i, j), A(i, j)) << "at (" << i << ", " << j << ")";
+}
+
+TEST_P(TextFormatTest, RoundTripRandomMatrix) {
+    Matrix A = Matrix::Random(20, 13);
+
+    std::stringstream ss;
+    Matrix::write_text(ss, A, GetParam());
+    Matrix B = Matrix::read_text(ss, GetParam());
+
+    EXPECT_DOUBLE_EQ(max_abs_error(B, to_arma(A)), 0.0);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Formats,
+    TextFormatTest,
+    ::testing::Values(TextFormat::Whitespace, TextFormat::CSV, TextFormat::TSV)
+);
+
+// ##### writer ##### //
+
+TEST(MatrixTextIO, SeparatorsAndPrecision) {
+    Matrix A(vec{1.0 / 3.0, 2.0, -0.5, 1e-7}, 2, 2);
+
+    std::ostringstream csv, tsv, ws;
+    Matrix::write_text(csv, A, TextFormat::CSV, 5);
+    Matrix::write_text(tsv, A, TextFormat::TSV, 5);
+    Matrix::write_text(ws, A, TextFormat::Whitespace, 5);
+
+    EXPECT_EQ(csv.str(), "0.33333,2\n-0.5,1e-07\n");
+    EXPECT_EQ(tsv.str(), "0.33333\t2\n-0.5\t1e-07\n");
+    EXPECT_EQ(ws.str(),  "0.33333 2\n-0.5 1e-07\n");
+}
+
+// a precision beyond the 767 significant digits a double can have prints
+// the exact decimal expansion, and must not overrun the output buffer
+TEST(MatrixTextIO, LargePrecision) {
+    vec v = {0.1, 5e-324, -1e300, 1.0 / 3.0};
+
+    std::stringstream ss;
+    Matrix::write_text(ss, v, TextFormat::Whitespace, 100000);
+    std::ostringstream clamped;
+    Matrix::write_text(clamped, v, TextFormat::Whitespace, 767);
+    EXPECT_EQ(ss.str(), clamped.str());
+
+    std::string first;
+    std::getline(ss, first);
+    EXPECT_EQ(first, "0.1000000000000000055511151231257827021181583404541015625");
+
+    ss.clear();
+    ss.seekg(0);
+    Matrix M = Matrix::read_text(ss);
+    ASSERT_EQ(M.get_num_rows(), 4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(M(i, 0), v[i]);
+    }
+
+    std::ostringstream huge;
+    Matrix::write_text(huge, Matrix::Random(4, 300), TextFormat::CSV,
+                       std::numeric_limits<int>::max());
+    std::string text = huge.str();
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 4);
+}
+
+TEST(MatrixTextIO, VectorWrittenAsColumn) {
+    vec v = {1.5, -2.0, 0.25};
+
+    std::stringstream ss;
+    Matrix::write_text(ss, v);
+    EXPECT_EQ(ss.str(), "1.5\n-2\n0.25\n");
+
+    Matrix M = Matrix::read_text(ss);
+    EXPECT_EQ(M.get_num_rows(), 3);
+    EXPECT_EQ(M.get_num_cols(), 1);
+}
+
+// operator<< must keep the old setw(8)/setprecision(4) layout
+TEST(MatrixTextIO, PrintMatchesIostreamFormatting) {
+    Matrix A = awkward_matrix();
+    A(0, 3) = 12345.678;
+    A(1, 2) = -98765.4321;
+    A(2, 2) = 0.00005;
+
+    std::ostringstream reference;
+    reference << std::fixed << std::setprecision(4) << "\n";
+    for (int i = 0; i < A.get_num_rows(); ++i) {
+        for (int j = 0; j < A.get_num_cols(); ++j) {
+            reference << std::setw(8) << A(i, j) << "  ";
+        }
+        reference << "\n";
+    }
+    reference << "\n";
+
+    std::ostringstream printed;
+    printed << A;
+    EXPECT_EQ(printed.str(), reference.str());
+
+    vec v = {1.0 / 3.0, -2.0, 1e6};
+    std::ostringstream vec_printed;
+    vec_printed << v;
+    EXPECT_EQ(vec_printed.str(), "0.3333\n-2.0000\n1000000.0000\n");
+}
+
+// ##### parser ##### //
+
+TEST(MatrixTextIO, ReadSkipsPaddingAndBlankLines) {
+    std::istringstream csv(" 1, 2 ,+3\r\n\n  \n4,5,6e1\n");
+    Matrix A = Matrix::read_text(csv, TextFormat::CSV);
+
+    ASSERT_EQ(A.get_num_rows(), 2);
+    ASSERT_EQ(A.get_num_cols(), 3);
+    EXPECT_DOUBLE_EQ(A(0, 2), 3.0);
+    EXPECT_DOUBLE_EQ(A(1, 2), 60.0);
+
+    std::istringstream ws("1\t 2   3\n4 5 6");  // no newline at the end
+    Matrix B = Matrix::read_text(ws);
+    EXPECT_TRUE(B == Matrix(vec{1, 2, 3, 4, 5, 6}, 2, 3));
+}
+
+TEST(MatrixTextIO, ReadRejectsRaggedRows) {
+    std::istringstream in("1 2 3\n4 5\n");
+    EXPECT_THROW(Matrix::read_text(in), InvalidMatrixSize);
+}
+
+TEST(MatrixTextIO, ReadRejectsBadValues) {
+    std::istringstream garbage("1 2\n3 x\n");
+    EXPECT_THROW(Matrix::read_text(garbage), std::runtime_error);
+
+    std::istringstream wrong_separator("1;2\n");
+    EXPECT_THROW(Matrix::read_text(wrong_separator, TextFormat::CSV), std::runtime_error);
+
+    std::istringstream missing("1,2,\n");
+    EXPECT_THROW(Matrix::read_text(missing, TextFormat::CSV), std::runtime_error);
+}
+
+TEST(MatrixTextIO, SaveAndLoadFile) {
+    Matrix A = Matrix::Random(6, 4);
+    Matrix::save_text(A, "text_io_roundtrip.csv", TextFormat::CSV);
+    Matrix B = Matrix::load_text("text_io_roundtrip.csv", TextFormat::CSV);
+    EXPECT_DOUBLE_EQ(max_abs_error(B, to_arma(A)), 0.0);
+
+    EXPECT_THROW(Matrix::load_text("does_not_exist/matrix.txt"), std::runtime_error);
+}
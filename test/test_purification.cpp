@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <armadillo>
+#include "matrix.h"
+#include "purification.hpp"
+#include "test_helpers.hpp"
+
+// this file includes tests for TC2 density matrix purification, checked
+// against the projector built from Armadillo's eigenvectors
+
+// projector onto the k lowest eigenvectors
+static arma::mat occupied_projector(const arma::mat& F, int k) {
+    arma::vec evals;
+    arma::mat evecs;
+    arma::eig_sym(evals, evecs, F);
+    arma::mat P = arma::zeros(F.n_rows, F.n_cols);
+    for (int c = 0; c < k; ++c) {
+        for (arma::uword i = 0; i < F.n_rows; ++i) {
+            for (arma::uword j = 0; j < F.n_cols; ++j) {
+                P(i, j) += evecs(i, c) * evecs(j, c);
+            }
+        }
+    }
+    return P;
+}
+
+// chain with alternating on-site energies, an insulator at half filling
+static Matrix dimerized_chain(int n) {
+    Matrix F(n, n, Matrix::zeroed);
+    for (int i = 0; i < n; ++i) {
+        F(i, i) = i % 2 == 0 ? -1.0 : 1.0;
+        if (i + 1 < n) F(i, i + 1) = F(i + 1, i) = -0.5;
+        if (i + 2 < n) F(i, i + 2) = F(i + 2, i) = 0.1;
+    }
+    return F;
+}
+
+TEST(Purification, DenseMatchesEigenprojector) {
+    int n = 120;
+    int k = 40;
+    Matrix F = random_symmetric_matrix(n);
+    PurificationResult<Matrix> res = purify_density(F, k);
+
+    EXPECT_TRUE(mats_close(res.density, occupied_projector(to_arma(F), k), 1e-8, 0.0));
+    EXPECT_NEAR(res.density.trace(), k, 1e-8);
+    EXPECT_LE(res.idempotency_error, 1e-10);
+    EXPECT_GT(res.iterations, 0);
+    EXPECT_LT(res.iterations, 100);
+}
+
+TEST(Purification, SparseChainMatchesDense) {
+    int n = 300;
+    Matrix F = dimerized_chain(n);
+    arma::mat P_ref = occupied_projector(to_arma(F), n / 2);
+
+    PurificationResult<Matrix> dense = purify_density(F, n / 2);
+    EXPECT_TRUE(mats_close(dense.density, P_ref, 1e-10, 0.0));
+
+    PurificationOptions options;
+    options.drop_tol = 1e-10;
+    PurificationResult<SparseMatrix> sparse = purify_density(SparseMatrix::from_dense(F), n / 2, options);
+    EXPECT_TRUE(mats_close(sparse.density.to_dense(), P_ref, 1e-7, 0.0));
+    EXPECT_LE(sparse.idempotency_error, 1e-7);
+    // the density matrix of an insulator decays, so it stays sparse
+    EXPECT_LT(sparse.density.density(), 0.5);
+}
+
+TEST(Purification, EdgeCasesAndErrors) {
+    int n = 10;
+    Matrix F = dimerized_chain(n);
+    EXPECT_LT(purify_density(F, 0).density.max_abs(), 1e-12);
+    EXPECT_TRUE(mats_close(purify_density(F, n).density, arma::eye(n, n), 1e-12, 0.0));
+
+    // a degenerate spectrum has no gap to purify across
+    EXPECT_THROW(purify_density(Matrix::Identity(n), n / 2), std::runtime_error);
+
+    EXPECT_THROW(purify_density(F, n + 1), InvalidMatrixSize);
+    EXPECT_THROW(purify_density(Matrix::Random(n, n), 2), InvalidMatrixSize);
+    EXPECT_THROW(purify_density(Matrix::Random(n, n + 1), 2), InvalidMatrixSize);
+}
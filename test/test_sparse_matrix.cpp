@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <armadillo>
+#include <cmath>
+#include "matrix.h"
+#include "parallel.hpp"
+#include "sparse_matrix.hpp"
+#include "davidson.hpp"
+#include "test_helpers.hpp"
+
+// this file includes tests for the CSR SparseMatrix, checked against
+// Armadillo on dense copies
+
+// symmetric matrix whose elements decay exponentially away from the
+// diagonal, like the density matrix of a gapped system
+static Matrix decaying_matrix(int n, double decay, std::uint64_t seed) {
+    Matrix R = Matrix::Random(n, n, seed);
+    Matrix A = R + R.t();
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            A(i, j) *= std::exp(-decay * std::abs(i - j));
+        }
+    }
+    return A;
+}
+
+// dense copy with the entries at or below tol set to zero
+static arma::mat thresholded(const arma::mat& A, double tol) {
+    arma::mat B = A;
+    for (arma::uword i = 0; i < B.n_rows; ++i) {
+        for (arma::uword j = 0; j < B.n_cols; ++j) {
+            if (std::abs(B(i, j)) <= tol) {
+                B(i, j) = 0.0;
+            }
+        }
+    }
+    return B;
+}
+
+TEST(SparseMatrix, ConversionAndAccess) {
+    int n = 150;
+    double tol = 1e-6;
+    Matrix A = decaying_matrix(n, 1.0, 1);
+    SparseMatrix S = SparseMatrix::from_dense(A, tol);
+    arma::mat A_ref = thresholded(to_arma(A), tol);
+
+    EXPECT_EQ(S.nnz(), static_cast<index_t>(arma::accu(arma::abs(A_ref) > 0.0)));
+    EXPECT_LT(S.density(), 0.25);
+    EXPECT_TRUE(mats_close(S.to_dense(), A_ref, 0.0, 0.0));
+    EXPECT_TRUE(mats_close(S.to_dense(Layout::ColMajor), A_ref, 0.0, 0.0));
+    EXPECT_EQ(S(3, 5), A(3, 5));
+    EXPECT_EQ(S(0, n - 1), 0.0);
+    EXPECT_TRUE(S.is_symmetric());
+
+    // column-major input gives the same CSR arrays
+    SparseMatrix Sc = SparseMatrix::from_dense(A.to_layout(Layout::ColMajor), tol);
+    EXPECT_EQ(Sc.get_row_ptr(), S.get_row_ptr());
+    EXPECT_EQ(Sc.get_col_idx(), S.get_col_idx());
+    EXPECT_EQ(Sc.get_values(), S.get_values());
+
+    EXPECT_TRUE(mats_close(S.prune(1e-3).to_dense(), thresholded(A_ref, 1e-3), 0.0, 0.0));
+    EXPECT_TRUE(mats_close(SparseMatrix::Identity(4).to_dense(), arma::eye(4, 4), 0.0, 0.0));
+
+    EXPECT_THROW(S(n, 0), std::out_of_range);
+    EXPECT_THROW(SparseMatrix(2, 2, {0, 1}, {0}, {1.0}), InvalidMatrixSize);
+    EXPECT_THROW(SparseMatrix(2, 2, {0, 1, 2}, {0, 2}, {1.0, 1.0}), std::out_of_range);
+    EXPECT_THROW(SparseMatrix(1, 3, {0, 2}, {1, 1}, {1.0, 1.0}), std::invalid_argument);
+    SparseMatrix M(2, 3, {0, 2, 3}, {0, 2, 1}, {1.0, 2.0, 3.0});
+    EXPECT_EQ(M(0, 2), 2.0);
+    EXPECT_EQ(M(1, 1), 3.0);
+}
+
+TEST(SparseMatrix, ArithmeticMatchesArmadillo) {
+    int n = 200;
+    SparseMatrix A = SparseMatrix::from_dense(decaying_matrix(n, 0.7, 2), 1e-8);
+    SparseMatrix B = SparseMatrix::from_dense(decaying_matrix(n, 0.3, 3), 1e-8);
+    arma::mat A_ref = to_arma(A.to_dense());
+    arma::mat B_ref = to_arma(B.to_dense());
+
+    EXPECT_TRUE(mats_close((A + B).to_dense(), A_ref + B_ref));
+    EXPECT_TRUE(mats_close((A - B).to_dense(), A_ref - B_ref));
+    EXPECT_TRUE(mats_close((2.5 * A).to_dense(), A_ref * 2.5));
+    EXPECT_TRUE(mats_close((A * B).to_dense(), A_ref * B_ref));
+    EXPECT_EQ((A - A).prune().nnz(), 0);
+
+    // truncated product: only entries above the tolerance survive
+    double tol = 1e-4;
+    SparseMatrix C = A.multiply(B, tol);
+    EXPECT_TRUE(mats_close(C.to_dense(), thresholded(A_ref * B_ref, tol), 1e-12, 0.0));
+    EXPECT_LT(C.nnz(), (A * B).nnz());
+
+    // rectangular operands, sparse times dense in both layouts, and vectors
+    Matrix D = decaying_matrix(n, 0.5, 4);
+    SparseMatrix R = SparseMatrix::from_dense(Matrix(vec(D.memptr(), D.memptr() + 60 * n), 60, n), 1e-6);
+    arma::mat R_ref = to_arma(R.to_dense());
+    Matrix X = Matrix::Random(n, 7);
+    EXPECT_TRUE(mats_close(R * X, R_ref * to_arma(X)));
+    Matrix Xc = X.to_layout(Layout::ColMajor);
+    Matrix Yc = R * Xc;
+    EXPECT_EQ(Yc.get_layout(), Layout::ColMajor);
+    EXPECT_TRUE(mats_close(Yc, R_ref * to_arma(X)));
+    EXPECT_TRUE(mats_close(R.transpose().to_dense(), R_ref.t(), 0.0, 0.0));
+    EXPECT_TRUE(mats_close((R * A).to_dense(), R_ref * A_ref));
+
+    vec x(n);
+    arma::vec x_ref(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = x_ref(i) = std::sin(i);
+    }
+    vec y = R * x;
+    arma::vec y_ref = R_ref * x_ref;
+    for (int i = 0; i < 60; ++i) {
+        EXPECT_NEAR(y[i], y_ref(i), 1e-12);
+    }
+
+    EXPECT_THROW(A + R, InvalidMatrixSize);
+    EXPECT_THROW(A * R, InvalidMatrixSize);
+    EXPECT_THROW(R * Matrix::Random(60, 3), InvalidMatrixSize);
+}
+
+TEST(SparseMatrix, IndependentOfThreadCount) {
+    int n = 3000;
+    SparseMatrix A = SparseMatrix::from_dense(decaying_matrix(n, 0.4, 5), 1e-8);
+    Matrix X = Matrix::Random(n, 16);
+    int saved = get_num_threads();
+
+    set_num_threads(1);
+    SparseMatrix C1 = A.multiply(A, 1e-10);
+    SparseMatrix S1 = A + C1;
+    Matrix Y1 = A * X;
+    set_num_threads(4);
+    SparseMatrix C4 = A.multiply(A, 1e-10);
+    SparseMatrix S4 = A + C4;
+    Matrix Y4 = A * X;
+    set_num_threads(saved);
+
+    EXPECT_EQ(C1.get_col_idx(), C4.get_col_idx());
+    EXPECT_EQ(C1.get_values(), C4.get_values());
+    EXPECT_EQ(S1.get_values(), S4.get_values());
+    EXPECT_TRUE(approx_equal(Y1, Y4, 0.0, 0.0));
+}
+
+TEST(SparseMatrix, DavidsonMatchesDense) {
+    int n = 400;
+    Matrix A = decaying_matrix(n, 1.0, 6);
+    for (int i = 0; i < n; ++i) {
+        A(i, i) += i + 1.0;
+    }
+    SparseMatrix S = SparseMatrix::from_dense(A, 1e-12);
+    DavidsonResult res = davidson(S, 4);
+    EigsymResult ref = S.to_dense().eigsym();
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_NEAR(res.eigenvalues[i], ref.eigenvalues[i], 1e-10);
+    }
+}